@@ -0,0 +1,38 @@
+#pragma once
+
+#include "problem.h"
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace vrp {
+/// Binary problem file parser
+/*!
+ * Versioned binary format that is memory-mapped on read: cost and time
+ * matrices are used in place, without parsing or copying. All sections are
+ * stored in native byte order and aligned to the matrix alignment
+ *
+ * Format:
+ *  > header: magic, version, byte order mark, cost value size, scalar values,
+ *    sizes and offsets of the sections
+ *  > customers: fixed-size records
+ *  > vehicles: fixed-size records
+ *  > suitable vehicles of all customers: int32 array
+ *  > cost matrix NxN where N is the number of customers
+ *  > time matrix NxN
+ */
+class BinaryParser {
+public:
+    static constexpr const uint32_t version = 1;  ///< current format version
+
+    /// Check whether file at path is a binary problem file
+    static bool is_binary(const std::string& path);
+
+    /// Memory-map file at path and read problem from it
+    Problem read(const std::string& path) const;
+
+    /// Write problem in binary format
+    void write(std::ostream& out, const Problem& prob) const;
+};
+}  // namespace vrp
@@ -2,17 +2,71 @@
 
 #include "problem.h"
 #include "solution.h"
+#include "time_window_segment.h"
 
 #include <cassert>
-#include <cmath>
 #include <ostream>
 
 namespace vrp {
 namespace constraints {
+/// Service time of customer in a route with given split info. Info is a
+/// SplitInfo or any type providing service time lookup via service_time()
+template<typename Info>
+inline int service_time(const Customer& c, const Info& info) {
+    return info.service_time(c);
+}
+
+/// Travel time between customers as used by time windows checks
+inline int travel_time(const Problem& prob, size_t from, size_t to) {
+    return static_cast<int>(prob.costs(from, to));
+}
+
+/// Time window segment of a single customer
+template<typename Info>
+inline TimeWindowSegment tw_segment(const Problem& prob, const Info& info,
+                                    size_t customer) {
+    const auto& c = prob.customers[customer];
+    return TimeWindowSegment::node(c.hard_tw.first, c.hard_tw.second,
+                                   service_time(c, info));
+}
+
+/// Time window segment of a customer that starts a route part
+template<typename Info>
+inline TimeWindowSegment tw_start_segment(const Problem& prob, const Info& info,
+                                          size_t customer) {
+    return TimeWindowSegment::start(
+        service_time(prob.customers[customer], info));
+}
+
+/// Concatenate time window segments: lhs ending with customer from, rhs
+/// starting with customer to
+inline TimeWindowSegment tw_concatenate(const Problem& prob,
+                                        const TimeWindowSegment& lhs,
+                                        size_t from, size_t to,
+                                        const TimeWindowSegment& rhs) {
+    return concatenate(lhs, travel_time(prob, from, to), rhs);
+}
+
+/// Time window segment of range [first, last), built node by node
+template<typename Info, typename ListIt>
+inline TimeWindowSegment tw_segment(const Problem& prob, const Info& info,
+                                    ListIt first, ListIt last) {
+    if (first == last) {
+        throw std::runtime_error("empty range provided");
+    }
+    auto segment = tw_segment(prob, info, *first);
+    for (auto next_first = std::next(first); next_first != last;
+         ++first, ++next_first) {
+        segment = tw_concatenate(prob, segment, *first, *next_first,
+                                 tw_segment(prob, info, *next_first));
+    }
+    return segment;
+}
+
 int total_violated_time(const Problem& prob, const Solution& sln);
 
-template<typename ListIt>
-inline int total_violated_time(const Problem& prob, const SplitInfo& info,
+template<typename Info, typename ListIt>
+inline int total_violated_time(const Problem& prob, const Info& info,
                                ListIt first, ListIt last) {
     static_assert(
         std::is_same<size_t, std::decay_t<typename std::iterator_traits<
@@ -22,10 +76,6 @@ inline int total_violated_time(const Problem& prob, const SplitInfo& info,
         throw std::runtime_error("unable to count violated time");
     }
 
-    const auto service_time = [&info](const Customer& c) -> int {
-        return static_cast<int>(std::ceil(info.at(c.id) * c.service_time));
-    };
-
     int violated_time = 0;
     auto next_first = std::next(first);
     const auto& customers = prob.customers;
@@ -43,8 +93,8 @@ inline int total_violated_time(const Problem& prob, const SplitInfo& info,
         //
         // * - W is the wait time if vehicle arrived to next_c earlier than
         //     next_c.hard_tw[0]
-        int spent_time_on_c =
-            start_time + service_time(c) + prob.costs[*first][*next_first];
+        int spent_time_on_c = start_time + service_time(c, info) +
+                              travel_time(prob, *first, *next_first);
 
         // include waiting for next_c TW start
         spent_time_on_c = std::max(spent_time_on_c, next_c.hard_tw.first);
@@ -52,7 +102,7 @@ inline int total_violated_time(const Problem& prob, const SplitInfo& info,
         // new start time on next_c is spent_time_on_c
         start_time = spent_time_on_c;
 
-        spent_time_on_c += service_time(next_c);
+        spent_time_on_c += service_time(next_c, info);
 
         violated_time += std::max(0, spent_time_on_c - next_c.hard_tw.second);
     }
@@ -79,7 +129,7 @@ total_violated_capacity(const Problem& prob, TransportationQuantity cap,
     for (; first != last; ++first) {
         const auto& c = customers[*first];
         assert(static_cast<size_t>(c.id) == *first);
-        cap -= (c.demand * info.at(c.id));
+        cap -= info.demand(c);
     }
 
     TransportationQuantity violated_capacity = {};
@@ -3,15 +3,46 @@
 #include "problem.h"
 #include "solution.h"
 
+#include <atomic>
 #include <cstdint>
+#include <limits>
 
 namespace vrp {
 /// Optimal heuristics types
 enum class ImprovementHeuristic : int8_t { Tabu = 0, Last };
 
-/// Create optimal solution with specified heuristic
+/// Best objective value of feasible solutions shared between concurrent
+/// improvement runs. Lock-free: runs publish their feasible bests and read
+/// the value to stop early when they fall far behind
+class SharedIncumbent {
+    std::atomic<double> m_value{std::numeric_limits<double>::max()};
+
+public:
+    /// Get current best value
+    inline double value() const noexcept {
+        return m_value.load(std::memory_order_relaxed);
+    }
+
+    /// Set value if it is better than the current one. Returns true if value
+    /// was updated
+    inline bool update(double value) noexcept {
+        double current = m_value.load(std::memory_order_relaxed);
+        while (value < current) {
+            if (m_value.compare_exchange_weak(current, value,
+                                              std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+/// Create optimal solution with specified heuristic. If incumbent is given,
+/// feasible solutions found are published to it and the search may stop
+/// early once it is hopelessly behind the incumbent
 Solution create_improved_solution(const Problem& prob,
                                   const Solution& initial_sln,
-                                  ImprovementHeuristic heuristic);
+                                  ImprovementHeuristic heuristic,
+                                  SharedIncumbent* incumbent = nullptr);
 
 }  // namespace vrp
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace vrp {
+/// Cost matrix value type: single precision if built WITH_FLOAT_COSTS
+#if VRP_FLOAT_COSTS
+using CostType = float;
+#else
+using CostType = double;
+#endif
+
+/// Time matrix value type
+using TimeType = int32_t;
+
+/// Arc record with interleaved cost and time of the same arc
+struct Arc {
+    CostType cost = 0;  ///< arc cost
+    TimeType time = 0;  ///< arc time
+};
+
+/// Dense matrix stored in a single cache-line-aligned row-major buffer
+/*!
+ * Element (i, j) lives at data()[i * cols() + j], so a full row is a
+ * contiguous range and there are no per-row allocations. operator[] returns a
+ * lightweight row view so the usual `m[i][j]` syntax keeps working
+ */
+template<typename T> class Matrix {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "matrix value type must be trivially copyable");
+
+public:
+    static constexpr const size_t alignment = 64;  ///< buffer alignment
+
+    /// Non-owning view of a matrix row
+    template<typename U> class RowView {
+        U* m_first = nullptr;
+        size_t m_size = 0;
+
+    public:
+        RowView(U* first, size_t size) noexcept
+            : m_first(first), m_size(size) {}
+
+        inline U& operator[](size_t j) const noexcept {
+            assert(j < m_size);
+            return m_first[j];
+        }
+        inline size_t size() const noexcept { return m_size; }
+        inline U* begin() const noexcept { return m_first; }
+        inline U* end() const noexcept { return m_first + m_size; }
+        inline const U* cbegin() const noexcept { return m_first; }
+        inline const U* cend() const noexcept { return m_first + m_size; }
+    };
+
+private:
+    std::unique_ptr<unsigned char[]> m_storage;  ///< raw (unaligned) storage
+    std::shared_ptr<void> m_owner;  ///< owner of external buffer, if any
+    T* m_data = nullptr;            ///< aligned start of data
+    size_t m_rows = 0;
+    size_t m_cols = 0;
+
+    void allocate(size_t rows, size_t cols) {
+        m_rows = rows;
+        m_cols = cols;
+        m_storage.reset();
+        m_owner.reset();
+        m_data = nullptr;
+        if (size() == 0) {
+            return;
+        }
+        size_t space = size() * sizeof(T) + alignment;
+        m_storage.reset(new unsigned char[space]);
+        void* first = m_storage.get();
+        first = std::align(alignment, size() * sizeof(T), first, space);
+        assert(first != nullptr);
+        m_data = static_cast<T*>(first);
+    }
+
+public:
+    Matrix() = default;
+    Matrix(size_t rows, size_t cols, const T& value = T()) {
+        allocate(rows, cols);
+        std::fill(m_data, m_data + size(), value);
+    }
+    /// Create matrix over external row-major buffer that is kept alive by
+    /// owner (e.g. memory-mapped file). Data is used in place, not copied
+    Matrix(T* data, size_t rows, size_t cols, std::shared_ptr<void> owner)
+        : m_owner(std::move(owner)), m_data(data), m_rows(rows), m_cols(cols) {
+    }
+    Matrix(const Matrix& other) {
+        allocate(other.m_rows, other.m_cols);
+        if (size() != 0) {
+            std::memcpy(m_data, other.m_data, size() * sizeof(T));
+        }
+    }
+    Matrix(Matrix&& other) noexcept { swap(other); }
+    Matrix& operator=(const Matrix& other) {
+        if (this != &other) {
+            Matrix copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+    Matrix& operator=(Matrix&& other) noexcept {
+        Matrix moved(std::move(other));
+        swap(moved);
+        return *this;
+    }
+
+    inline void swap(Matrix& other) noexcept {
+        std::swap(m_storage, other.m_storage);
+        std::swap(m_owner, other.m_owner);
+        std::swap(m_data, other.m_data);
+        std::swap(m_rows, other.m_rows);
+        std::swap(m_cols, other.m_cols);
+    }
+
+    inline size_t rows() const noexcept { return m_rows; }
+    inline size_t cols() const noexcept { return m_cols; }
+    inline size_t size() const noexcept { return m_rows * m_cols; }
+    inline bool empty() const noexcept { return size() == 0; }
+
+    inline T* data() noexcept { return m_data; }
+    inline const T* data() const noexcept { return m_data; }
+
+    /// Element access without bounds checking (only asserted)
+    inline T& operator()(size_t i, size_t j) noexcept {
+        assert(i < m_rows && j < m_cols);
+        return m_data[i * m_cols + j];
+    }
+    inline const T& operator()(size_t i, size_t j) const noexcept {
+        assert(i < m_rows && j < m_cols);
+        return m_data[i * m_cols + j];
+    }
+
+    /// Element access with bounds checking
+    inline const T& at(size_t i, size_t j) const {
+        if (i >= m_rows || j >= m_cols) {
+            throw std::out_of_range("matrix index out of range");
+        }
+        return (*this)(i, j);
+    }
+
+    inline RowView<T> operator[](size_t i) noexcept {
+        assert(i < m_rows);
+        return RowView<T>(m_data + i * m_cols, m_cols);
+    }
+    inline RowView<const T> operator[](size_t i) const noexcept {
+        assert(i < m_rows);
+        return RowView<const T>(m_data + i * m_cols, m_cols);
+    }
+};
+
+/// Cost matrix type
+using CostMatrix = Matrix<CostType>;
+/// Time matrix type
+using TimeMatrix = Matrix<TimeType>;
+/// Interleaved cost and time matrix type
+using ArcMatrix = Matrix<Arc>;
+}  // namespace vrp
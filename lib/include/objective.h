@@ -4,9 +4,14 @@
 #include "solution.h"
 
 namespace vrp {
-/// Objective function for solution
+/// Objective function for solution. Uses objective values cached in routes,
+/// routes without up to date value are computed
 double objective(const Problem& prob, const Solution& sln);
 
+/// Objective function for solution. Also caches objective values of the
+/// routes that are computed
+double objective(const Problem& prob, Solution& sln);
+
 /// Objective function for route
 double objective(const Problem& prob, Solution::VehicleIndex vi,
                  const Solution::RouteType& route);
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+
+namespace vrp {
+namespace perf {
+/// Check whether library is built with performance counters
+/// (WITH_PERF_COUNTERS cmake option)
+bool enabled() noexcept;
+
+/// Get total number of tabu search iterations of all threads. 0 if counters
+/// are compiled out
+uint64_t tabu_iterations();
+
+/// Reset counters of all threads. Must not be called while counted code runs
+void reset();
+
+/// Write counter totals of all threads as JSON document. If counters are
+/// compiled out, the document only reports that they are disabled
+void write_json(std::ostream& out);
+}  // namespace perf
+}  // namespace vrp
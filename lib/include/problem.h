@@ -1,12 +1,14 @@
 #pragma once
 
 #include "customer.h"
+#include "matrix.h"
 #include "vehicle.h"
 
 #include <algorithm>
 #include <cstdint>
 #include <limits>
 #include <list>
+#include <numeric>
 #include <unordered_map>
 #include <vector>
 
@@ -32,6 +34,15 @@ private:
                                                      /// for each customer:
                                                      /// true means allowed,
                                                      /// false otherwise
+    size_t m_neighbours_count = 0;  ///< candidate list size, 0 means disabled
+    std::vector<std::vector<size_t>> m_neighbours;  ///< candidate lists: k
+                                                    /// nearest customers by
+                                                    /// cost for each customer
+    bool m_combine_arc_costs = false;  ///< combined arc costs are enabled
+    std::vector<CostMatrix> m_arc_costs;  ///< combined arc costs: one matrix
+                                          /// per distinct variable cost
+    std::vector<size_t> m_vehicle_arc_costs;  ///< index of combined arc costs
+                                              /// matrix for each vehicle
 
     template<typename IntegerT>
     std::vector<size_t> to_vector(const std::list<IntegerT>& l) {
@@ -110,10 +121,13 @@ private:
     }
 
 public:
-    std::vector<std::vector<double>> costs = {};  ///< cost matrix
-    std::vector<Customer> customers = {};         ///< customer list
-    std::vector<Vehicle> vehicles = {};           ///< vehicles list
-    std::vector<std::vector<int>> times = {};     ///< time matrix
+    CostMatrix costs = {};                 ///< cost matrix
+    std::vector<Customer> customers = {};  ///< customer list
+    std::vector<Vehicle> vehicles = {};    ///< vehicles list
+    TimeMatrix times = {};                 ///< time matrix
+    ArcMatrix arcs = {};  ///< interleaved costs and times. only filled by
+                          /// set_up() if interleave_arcs is true
+    bool interleave_arcs = false;  ///< build arcs in addition to costs/times
     int max_violated_soft_tw =
         std::numeric_limits<int>::max();  ///< max number of violated
                                           /// soft time windows
@@ -127,6 +141,25 @@ public:
     void set_up() {
         m_vehicle_types = create_vehicle_types();
 
+        // set candidate lists
+        set_up_neighbours(m_neighbours_count);
+
+        // set combined arc costs
+        set_up_arc_costs(m_combine_arc_costs);
+
+        // set interleaved arcs
+        if (interleave_arcs) {
+            const auto rows = costs.rows(), cols = costs.cols();
+            arcs = ArcMatrix(rows, cols);
+            for (size_t i = 0; i < rows; ++i) {
+                for (size_t j = 0; j < cols; ++j) {
+                    arcs(i, j) = Arc{costs(i, j), times(i, j)};
+                }
+            }
+        } else {
+            arcs = ArcMatrix();
+        }
+
         // set allowed types
         const auto customers_size = n_customers();
         const auto types_size = m_vehicle_types.size();
@@ -166,6 +199,76 @@ public:
         }
     }
 
+    /// Set up granular neighbourhoods: for each customer, keep k nearest (by
+    /// cost) customers sorted in ascending order of cost. Depot is never a
+    /// candidate. k = 0 disables candidate lists
+    void set_up_neighbours(size_t k) {
+        const auto customers_size = n_customers();
+        m_neighbours.clear();
+        m_neighbours_count = 0;
+        if (k == 0 || customers_size < 3) {
+            return;
+        }
+        m_neighbours_count = std::min(k, customers_size - 2);
+
+        m_neighbours.resize(customers_size, {});
+        std::vector<size_t> candidates(customers_size - 2);
+        for (size_t c = 1; c < customers_size; ++c) {
+            // all customers except depot and c itself
+            const auto c_pos = candidates.begin() + (c - 1);
+            std::iota(candidates.begin(), c_pos, size_t(1));
+            std::iota(c_pos, candidates.end(), c + 1);
+
+            const auto middle = candidates.begin() + m_neighbours_count;
+            const auto& costs_from_c = costs[c];
+            std::partial_sort(candidates.begin(), middle, candidates.end(),
+                              [&costs_from_c](size_t a, size_t b) {
+                                  return costs_from_c[a] < costs_from_c[b];
+                              });
+            m_neighbours[c].assign(candidates.begin(), middle);
+        }
+    }
+
+    /// Set up combined arc costs: for each distinct vehicle variable cost,
+    /// precompute variable_cost * cost + time_coeff * time for every arc, so
+    /// that a route's objective is a single lookup per arc. Vehicles with
+    /// equal variable costs share a matrix. false disables combined costs
+    void set_up_arc_costs(bool enable) {
+        m_arc_costs.clear();
+        m_vehicle_arc_costs.clear();
+        m_combine_arc_costs = enable;
+        if (!enable) {
+            return;
+        }
+
+        const auto rows = costs.rows(), cols = costs.cols();
+        std::vector<double> variable_costs;
+        m_vehicle_arc_costs.reserve(n_vehicles());
+        for (const auto& vehicle : vehicles) {
+            const auto found = std::find(variable_costs.cbegin(),
+                                         variable_costs.cend(),
+                                         vehicle.variable_cost);
+            m_vehicle_arc_costs.emplace_back(
+                std::distance(variable_costs.cbegin(), found));
+            if (found != variable_costs.cend()) {
+                continue;
+            }
+            variable_costs.emplace_back(vehicle.variable_cost);
+            m_arc_costs.emplace_back(rows, cols);
+            auto& arc_costs = m_arc_costs.back();
+            for (size_t i = 0; i < rows; ++i) {
+                const auto costs_from_i = costs[i];
+                const auto times_from_i = times[i];
+                auto arc_costs_from_i = arc_costs[i];
+                for (size_t j = 0; j < cols; ++j) {
+                    arc_costs_from_i[j] = static_cast<CostType>(
+                        vehicle.variable_cost * costs_from_i[j] +
+                        time_coeff * times_from_i[j]);
+                }
+            }
+        }
+    }
+
     inline size_t n_customers() const { return this->customers.size(); }
     inline size_t n_vehicles() const { return this->vehicles.size(); }
     /// Get allowed vehicles for customer. Expected `customer` param is 0-based
@@ -186,5 +289,19 @@ public:
     }
     /// Get status of split delivery
     inline bool enable_splits() const { return max_splits > 1; }
+    /// Get status of granular neighbourhoods
+    inline bool granular() const { return m_neighbours_count > 0; }
+    /// Get candidate list for customer. Expected `customer` param is 0-based
+    inline const std::vector<size_t>& neighbours(size_t customer) const {
+        return m_neighbours[customer];
+    }
+    /// Get status of combined arc costs
+    inline bool combined_arc_costs() const { return m_combine_arc_costs; }
+    /// Get arc costs of vehicle: combined arc costs if set up, plain cost
+    /// matrix otherwise. Expected `vehicle` param is 0-based
+    inline const CostMatrix& arc_costs(size_t vehicle) const {
+        return m_combine_arc_costs ? m_arc_costs[m_vehicle_arc_costs[vehicle]]
+                                   : costs;
+    }
 };
 }  // namespace vrp
@@ -0,0 +1,260 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace vrp {
+/// Route representation: customers stored contiguously in visiting order
+/*!
+ * Positional access is O(1) and iterators are random access. Unlike
+ * std::list, structural changes (insert, erase, splice) invalidate iterators
+ * at and after the modified position, so callers that mutate a route are
+ * expected to work with positions, not iterators
+ *
+ * Nodes are shared between copies of a route: copying a route copies a
+ * pointer, nodes are cloned by the first modification of a shared route. Any
+ * modification of a shared route invalidates all of its iterators
+ *
+ * Route keeps a cache of its objective value. Nodes are only modified through
+ * member functions, each of them invalidates the cache
+ */
+class Route {
+public:
+    using value_type = size_t;
+    using container_type = std::vector<value_type>;
+    /// nodes are modified through member functions only
+    using iterator = container_type::const_iterator;
+    using const_iterator = container_type::const_iterator;
+    using size_type = container_type::size_type;
+
+private:
+    /// Nodes shared by copies of a route
+    struct Block {
+        std::atomic<size_t> refs{1};  ///< number of routes sharing the block
+        container_type nodes;
+
+        Block() = default;
+        explicit Block(container_type nodes) : nodes(std::move(nodes)) {}
+    };
+
+    Block* m_block = nullptr;        ///< nodes. null if route is empty
+    double m_objective = 0.0;        ///< cached objective value
+    size_t m_objective_vehicle = 0;  ///< vehicle the cached value is for
+    bool m_objective_valid = false;  ///< whether cached value is up to date
+
+    inline void invalidate() noexcept { m_objective_valid = false; }
+
+    inline const container_type& nodes() const noexcept {
+        static const container_type no_nodes = {};
+        return m_block ? m_block->nodes : no_nodes;
+    }
+
+    /// Get nodes for modification, cloning them if shared
+    inline container_type& own_nodes() {
+        if (!m_block) {
+            m_block = new Block();
+        } else if (m_block->refs.load(std::memory_order_acquire) != 1) {
+            Block* copy = new Block(m_block->nodes);
+            release();
+            m_block = copy;
+        }
+        invalidate();
+        return m_block->nodes;
+    }
+
+    inline void release() noexcept {
+        if (m_block &&
+            m_block->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete m_block;
+        }
+        m_block = nullptr;
+    }
+
+    inline size_type offset(const_iterator pos) const noexcept {
+        return static_cast<size_type>(pos - nodes().cbegin());
+    }
+
+public:
+    Route() = default;
+    Route(std::initializer_list<value_type> nodes)
+        : m_block(new Block(nodes)) {}
+    template<typename InputIt>
+    Route(InputIt first, InputIt last)
+        : m_block(new Block(container_type(first, last))) {}
+
+    Route(const Route& other) noexcept
+        : m_block(other.m_block), m_objective(other.m_objective),
+          m_objective_vehicle(other.m_objective_vehicle),
+          m_objective_valid(other.m_objective_valid) {
+        if (m_block) {
+            m_block->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    Route(Route&& other) noexcept
+        : m_block(other.m_block), m_objective(other.m_objective),
+          m_objective_vehicle(other.m_objective_vehicle),
+          m_objective_valid(other.m_objective_valid) {
+        other.m_block = nullptr;
+        other.invalidate();
+    }
+    Route& operator=(const Route& other) noexcept {
+        Route(other).swap(*this);
+        return *this;
+    }
+    Route& operator=(Route&& other) noexcept {
+        Route(std::move(other)).swap(*this);
+        return *this;
+    }
+    ~Route() { release(); }
+
+    inline void swap(Route& other) noexcept {
+        std::swap(m_block, other.m_block);
+        std::swap(m_objective, other.m_objective);
+        std::swap(m_objective_vehicle, other.m_objective_vehicle);
+        std::swap(m_objective_valid, other.m_objective_valid);
+    }
+
+    inline size_type size() const noexcept { return nodes().size(); }
+    inline bool empty() const noexcept { return nodes().empty(); }
+    inline void reserve(size_type n) { own_nodes().reserve(n); }
+    inline void clear() noexcept {
+        release();
+        invalidate();
+    }
+
+    inline const_iterator begin() const noexcept { return nodes().cbegin(); }
+    inline const_iterator end() const noexcept { return nodes().cend(); }
+    inline const_iterator cbegin() const noexcept { return nodes().cbegin(); }
+    inline const_iterator cend() const noexcept { return nodes().cend(); }
+
+    inline value_type front() const { return nodes().front(); }
+    inline value_type back() const { return nodes().back(); }
+
+    /// Element access without bounds checking
+    inline value_type operator[](size_type i) const noexcept {
+        return m_block->nodes[i];
+    }
+
+    /// Replace value at position i
+    inline void set(size_type i, value_type v) { own_nodes()[i] = v; }
+
+    /// Swap values at positions i and j
+    inline void swap_nodes(size_type i, size_type j) {
+        auto& nodes = own_nodes();
+        std::swap(nodes[i], nodes[j]);
+    }
+
+    /// Element access with bounds checking
+    inline value_type at(size_type i) const {
+        if (i >= size()) {
+            throw std::out_of_range("i >= route size");
+        }
+        return m_block->nodes[i];
+    }
+
+    inline void push_back(value_type v) { own_nodes().push_back(v); }
+    inline void emplace_back(value_type v) { own_nodes().emplace_back(v); }
+    inline void emplace_front(value_type v) {
+        auto& nodes = own_nodes();
+        nodes.insert(nodes.begin(), v);
+    }
+
+    /// Insert value before position i. Returns position of inserted value
+    inline size_type insert(size_type i, value_type v) {
+        auto& nodes = own_nodes();
+        nodes.insert(nodes.begin() + i, v);
+        return i;
+    }
+    inline const_iterator insert(const_iterator pos, value_type v) {
+        const auto i = offset(pos);
+        auto& nodes = own_nodes();
+        return nodes.insert(nodes.cbegin() + i, v);
+    }
+    template<typename InputIt>
+    inline const_iterator insert(const_iterator pos, InputIt first,
+                                 InputIt last) {
+        const auto i = offset(pos);
+        auto& nodes = own_nodes();
+        return nodes.insert(nodes.cbegin() + i, first, last);
+    }
+
+    /// Erase value at position i. Returns position of the following value
+    inline size_type erase(size_type i) {
+        auto& nodes = own_nodes();
+        nodes.erase(nodes.begin() + i);
+        return i;
+    }
+    inline const_iterator erase(const_iterator pos) {
+        const auto i = offset(pos);
+        auto& nodes = own_nodes();
+        return nodes.erase(nodes.cbegin() + i);
+    }
+    inline const_iterator erase(const_iterator first, const_iterator last) {
+        const auto i = offset(first), j = offset(last);
+        auto& nodes = own_nodes();
+        return nodes.erase(nodes.cbegin() + i, nodes.cbegin() + j);
+    }
+
+    /// Move [first, last) from other route to this route before pos
+    inline void splice(const_iterator pos, Route& other, const_iterator first,
+                       const_iterator last) {
+        const auto i = other.offset(first), j = other.offset(last);
+        insert(pos, first, last);
+        other.erase(other.cbegin() + i, other.cbegin() + j);
+    }
+
+    /// Reverse positions [first, last)
+    inline void reverse(size_type first, size_type last) {
+        auto& nodes = own_nodes();
+        std::reverse(nodes.begin() + first, nodes.begin() + last);
+    }
+
+    /// Swap tails of two different routes starting at given positions:
+    /// lhs[lhs_first:] <-> rhs[rhs_first:]
+    friend inline void swap_tails(Route& lhs, size_type lhs_first, Route& rhs,
+                                  size_type rhs_first) {
+        const auto lhs_tail = lhs.size() - lhs_first;
+        const auto rhs_tail = rhs.size() - rhs_first;
+        const auto common = std::min(lhs_tail, rhs_tail);
+        auto& lhs_nodes = lhs.own_nodes();
+        auto& rhs_nodes = rhs.own_nodes();
+        std::swap_ranges(lhs_nodes.begin() + lhs_first,
+                         lhs_nodes.begin() + lhs_first + common,
+                         rhs_nodes.begin() + rhs_first);
+        // move the remainder of the longer tail to the shorter one
+        if (lhs_tail > rhs_tail) {
+            rhs.splice(rhs.cend(), lhs, lhs.cbegin() + lhs_first + common,
+                       lhs.cend());
+        } else if (rhs_tail > lhs_tail) {
+            lhs.splice(lhs.cend(), rhs, rhs.cbegin() + rhs_first + common,
+                       rhs.cend());
+        }
+    }
+
+    /// Check whether cached objective is up to date for given vehicle
+    inline bool has_objective(size_t vehicle) const noexcept {
+        return m_objective_valid && m_objective_vehicle == vehicle;
+    }
+    /// Get cached objective. Valid only if has_objective() is true
+    inline double objective() const noexcept { return m_objective; }
+    /// Cache objective of the route served by vehicle
+    inline void set_objective(size_t vehicle, double value) noexcept {
+        m_objective = value;
+        m_objective_vehicle = vehicle;
+        m_objective_valid = true;
+    }
+
+    inline bool operator==(const Route& other) const {
+        return m_block == other.m_block || nodes() == other.nodes();
+    }
+    inline bool operator!=(const Route& other) const {
+        return !(*this == other);
+    }
+};
+}  // namespace vrp
@@ -1,11 +1,15 @@
 #pragma once
 
 #include "problem.h"
+#include "route.h"
 #include "route_point.h"
+#include "time_window_segment.h"
 #include "vehicle.h"
 
-#include <list>
-#include <unordered_map>
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <stdexcept>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -13,41 +17,207 @@
 namespace vrp {
 /// Split info representation
 struct SplitInfo {
-    // TODO: decide upon proper design and usage
+    /// Share of customer demand delivered by a route: integer units of demand
+    /// volume out of the whole demand, so that sums of shares are exact
     struct Ratio {
-        double d = 1.0;  ///< ratio as a double value
-        inline operator double() const noexcept { return d; }
-        inline Ratio& operator=(double v) {
-            d = v;
-            return *this;
-        }
+        int units = 1;  ///< delivered units
+        int total = 1;  ///< units of the whole demand
+
         Ratio() = default;
-        inline Ratio(double v) : d(v) {}
-        inline Ratio& operator+=(const Ratio& other) {
-            d += other.d;
+        inline Ratio(int units, int total) noexcept
+            : units(units), total(total) {}
+
+        /// Units of the whole demand of customer: its volume. Customers without
+        /// volume have a single unit
+        static inline int total_units(const Customer& c) noexcept {
+            return std::max(1, c.demand.volume);
+        }
+        /// Share of customer demand given in units
+        static inline Ratio of(const Customer& c, int units) noexcept {
+            return Ratio(units, total_units(c));
+        }
+        /// Whole demand of customer
+        static inline Ratio whole_of(const Customer& c) noexcept {
+            const int total = total_units(c);
+            return Ratio(total, total);
+        }
+
+        /// Ratio delivers the whole demand
+        inline bool whole() const noexcept { return units == total; }
+        /// Ratio delivers a part of the demand
+        inline bool partial() const noexcept {
+            return units > 0 && units < total;
+        }
+        inline double value() const noexcept {
+            return static_cast<double>(units) / total;
+        }
+
+        inline Ratio& operator+=(const Ratio& other) noexcept {
+            assert(total == other.total);
+            units += other.units;
             return *this;
         }
-        inline Ratio& operator-=(const Ratio& other) {
-            d -= other.d;
+        inline Ratio& operator-=(const Ratio& other) noexcept {
+            assert(total == other.total);
+            units -= other.units;
             return *this;
         }
+        inline Ratio operator+(const Ratio& other) const noexcept {
+            return Ratio(*this) += other;
+        }
+        inline Ratio operator-(const Ratio& other) const noexcept {
+            return Ratio(*this) -= other;
+        }
+    };
+
+    /// Split of a customer: its ratio with demand and service time delivered
+    /// by the route. Computed once when the ratio changes
+    struct Split {
+        Ratio ratio;
+        TransportationQuantity demand;  ///< delivered demand
+        int service_time = 0;           ///< service time of delivered demand
+
+        Split() = default;
+        inline Split(const Customer& c, Ratio r) noexcept
+            : ratio(r), demand(c.demand), service_time(c.service_time) {
+            if (!r.whole()) {
+                demand = {ceil_share(c.demand.volume, r),
+                          ceil_share(c.demand.weight, r)};
+                service_time = ceil_share(c.service_time, r);
+            }
+        }
+
+        /// Share of value rounded up, same as std::ceil(ratio * value)
+        static inline int ceil_share(int value, Ratio r) noexcept {
+            const int64_t num = int64_t(value) * r.units;
+            const int64_t q = num / r.total;
+            return static_cast<int>(q + (num % r.total != 0 && num > 0));
+        }
     };
-    std::unordered_map<size_t, Ratio> split_info;  ///< index mapped to ratio
+
+    /// Flat map of splits sorted by index. Routes hold a few entries, so
+    /// lookups are binary searches in a single contiguous buffer
+    class Splits {
+    public:
+        using value_type = std::pair<size_t, Split>;
+        using iterator = std::vector<value_type>::iterator;
+        using const_iterator = std::vector<value_type>::const_iterator;
+
+    private:
+        std::vector<value_type> m_entries;
+
+        inline const_iterator lower_bound(size_t i) const noexcept {
+            return std::lower_bound(
+                m_entries.cbegin(), m_entries.cend(), i,
+                [](const value_type& e, size_t i) { return e.first < i; });
+        }
+
+    public:
+        inline iterator begin() noexcept { return m_entries.begin(); }
+        inline iterator end() noexcept { return m_entries.end(); }
+        inline const_iterator begin() const noexcept {
+            return m_entries.cbegin();
+        }
+        inline const_iterator end() const noexcept { return m_entries.cend(); }
+        inline const_iterator cbegin() const noexcept {
+            return m_entries.cbegin();
+        }
+        inline const_iterator cend() const noexcept { return m_entries.cend(); }
+        inline size_t size() const noexcept { return m_entries.size(); }
+        inline bool empty() const noexcept { return m_entries.empty(); }
+
+        inline const_iterator find(size_t i) const noexcept {
+            const auto it = lower_bound(i);
+            return (it != m_entries.cend() && it->first == i) ? it
+                                                              : m_entries.cend();
+        }
+        inline iterator find(size_t i) noexcept {
+            const auto it =
+                m_entries.begin() + (lower_bound(i) - m_entries.cbegin());
+            return (it != m_entries.end() && it->first == i) ? it
+                                                             : m_entries.end();
+        }
+
+        /// Get split of index, inserting empty split if index is missing
+        inline Split& operator[](size_t i) {
+            const auto it = lower_bound(i);
+            if (it != m_entries.cend() && it->first == i) {
+                return m_entries[it - m_entries.cbegin()].second;
+            }
+            return m_entries.insert(it, value_type(i, Split{}))->second;
+        }
+        inline Split& at(size_t i) {
+            const auto it = find(i);
+            if (it == m_entries.end()) {
+                throw std::out_of_range("split info has no given index");
+            }
+            return it->second;
+        }
+        inline const Split& at(size_t i) const {
+            const auto it = find(i);
+            if (it == m_entries.cend()) {
+                throw std::out_of_range("split info has no given index");
+            }
+            return it->second;
+        }
+
+        /// Remove index. Returns number of removed entries
+        inline size_t erase(size_t i) {
+            const auto it = find(i);
+            if (it == m_entries.end()) {
+                return 0;
+            }
+            m_entries.erase(it);
+            return 1;
+        }
+        inline void clear() noexcept { m_entries.clear(); }
+    };
+
+    Splits split_info;  ///< index mapped to split
+    bool full = false;  ///< every customer is delivered in full. no entries
+                        ///< are stored: used when splits are disabled
+
+    /// Split info of a route that may serve any customer in full
+    static inline SplitInfo all_customers() {
+        SplitInfo info;
+        info.full = true;
+        return info;
+    }
+
     inline bool has(size_t i) const noexcept {
-        return split_info.cend() != split_info.find(i);
+        return full || split_info.cend() != split_info.find(i);
     }
     inline bool has_any(const std::vector<size_t>& is) const noexcept {
         return std::any_of(is.cbegin(), is.cend(),
                            [this](size_t i) { return has(i); });
     }
-    inline const Ratio& at(size_t i) const {
-        thread_local const Ratio depot_ratio = 1.0;
-        if (i == 0) {
-            return depot_ratio;
+    /// Get ratio of customer. Depot and customers of full split info have
+    /// ratio 1
+    inline Ratio at(size_t i) const {
+        if (i == 0 || full) {
+            return Ratio();
+        }
+        return split_info.at(i).ratio;
+    }
+    /// Get demand of customer delivered by the route
+    inline TransportationQuantity demand(const Customer& c) const {
+        if (c.id == 0 || full) {
+            return c.demand;
+        }
+        return split_info.at(c.id).demand;
+    }
+    /// Get service time of customer in the route
+    inline int service_time(const Customer& c) const {
+        if (c.id == 0 || full) {
+            return c.service_time;
         }
-        return split_info.at(i);
+        return split_info.at(c.id).service_time;
     }
-    inline bool empty() const noexcept { return split_info.empty(); }
+    /// Set ratio of customer, computing its delivered demand and service time
+    inline void set(const Customer& c, Ratio r) {
+        split_info[c.id] = Split(c, r);
+    }
+    inline bool empty() const noexcept { return !full && split_info.empty(); }
 };
 
 void transfer_split_entry(bool enable_splits, SplitInfo& src, SplitInfo& dst,
@@ -65,20 +235,93 @@ inline void transfer_split_entry(bool enable_splits, SplitInfo& src,
     }
 }
 
+/// Routes serving each customer and positions of the customer in them. Flat
+/// storage with a fixed number of slots per customer (max splits): updates do
+/// not allocate. Owners of a customer are ordered by descending route index
+class CustomerOwners {
+public:
+    using Owner = std::pair<size_t, size_t>;  ///< route index and position of
+                                              ///< customer in the route
+
+    /// Non-owning view of the owners of a customer
+    class Owners {
+        const Owner* m_first = nullptr;
+        const Owner* m_last = nullptr;
+
+    public:
+        inline Owners(const Owner* first, const Owner* last) noexcept
+            : m_first(first), m_last(last) {}
+        inline const Owner* begin() const noexcept { return m_first; }
+        inline const Owner* end() const noexcept { return m_last; }
+        inline const Owner* cbegin() const noexcept { return m_first; }
+        inline const Owner* cend() const noexcept { return m_last; }
+        inline size_t size() const noexcept { return m_last - m_first; }
+        inline bool empty() const noexcept { return m_first == m_last; }
+    };
+
+private:
+    std::vector<Owner> m_slots;    ///< owners of all customers
+    std::vector<uint32_t> m_sizes;  ///< number of owners of each customer
+    size_t m_capacity = 0;          ///< number of slots per customer
+
+    inline Owner* first(size_t customer) noexcept {
+        return m_slots.data() + customer * m_capacity;
+    }
+    inline const Owner* first(size_t customer) const noexcept {
+        return m_slots.data() + customer * m_capacity;
+    }
+
+public:
+    /// Remove all owners, allocating slots for given number of customers
+    void reset(size_t customers, size_t max_owners);
+
+    /// Number of customers
+    inline size_t size() const noexcept { return m_sizes.size(); }
+    inline bool empty() const noexcept { return m_sizes.empty(); }
+
+    /// Get owners of customer
+    inline Owners operator[](size_t customer) const noexcept {
+        assert(customer < size());
+        return Owners(first(customer), first(customer) + m_sizes[customer]);
+    }
+
+    /// Get position of customer in route. Throws if route is not an owner
+    size_t at(size_t customer, size_t route) const;
+
+    /// Set position of customer in route, adding route to owners if needed
+    void set(size_t customer, size_t route, size_t index);
+
+    /// Remove route from owners of customer if present
+    void erase(size_t customer, size_t route);
+
+    /// Change index of owner route, keeping position of customer in it
+    void rename(size_t customer, size_t route, size_t new_route);
+};
+
+/// Time window segments of a route
+struct RouteTimeWindows {
+    std::vector<TimeWindowSegment> forward;  ///< segment of positions [0, i]
+                                             ///< for each position i. route
+                                             ///< prefixes carry exact
+                                             ///< violated time
+    std::vector<TimeWindowSegment> backward;  ///< segment of positions
+                                              ///< [i, size) for each
+                                              ///< position i
+};
+
 /// Solution representation
 class Solution {
 public:
     using VehicleIndex = size_t;   ///< vehicle index in problem's vector
     using CustomerIndex = size_t;  ///< customer index in problem's vector
-    using RouteType = std::list<CustomerIndex>;
+    using RouteType = Route;
     std::vector<std::pair<VehicleIndex, RouteType>> routes;
 
-    std::vector<std::pair<VehicleIndex, std::list<RoutePointTime>>> times;
+    std::vector<std::pair<VehicleIndex, std::vector<RoutePointTime>>> times;
 
-    std::vector<std::unordered_map<size_t, size_t>>
-        customer_owners;  ///< specifies which route
-                          ///< each customer belongs to and what index customer
-                          ///< has
+    CustomerOwners customer_owners;  ///< specifies which route each customer
+                                     ///< belongs to and what index customer
+                                     ///< has
 
     std::unordered_set<VehicleIndex>
         used_vehicles;  ///< vehicles used by solution
@@ -87,6 +330,11 @@ public:
     //       routes
     std::vector<SplitInfo> route_splits;  ///< split info for each route
 
+    std::vector<RouteTimeWindows>
+        tw_segments;  ///< time window segments for each route. not kept up to
+                      ///< date automatically: refresh after routes or splits
+                      ///< change
+
     void update_times(const Problem& prob);
 
     void update_customer_owners(const Problem& prob);
@@ -95,8 +343,55 @@ public:
 
     void update_used_vehicles();
 
+    void update_tw_segments(const Problem& prob);
+    void update_tw_segments(const Problem& prob, size_t route_index);
+
     bool operator==(const Solution& other) const;
 
     inline operator bool() const noexcept { return this->routes.empty(); }
 };
+
+/// Undo log of solution changes
+/*!
+ * Routes are recorded before their first change within a transaction:
+ * vehicle, nodes, split info and time window segments. Rollback restores only
+ * the recorded routes and owners of their customers, so a trial sequence of
+ * moves is reverted in time proportional to the change, not to the solution
+ * size
+ *
+ * Routes may be appended during a transaction, they are removed on rollback.
+ * Routes must not be erased during a transaction
+ */
+class SolutionJournal {
+    /// State of a route before its first change
+    struct RouteEntry {
+        size_t index = 0;
+        Solution::VehicleIndex vehicle = 0;
+        Solution::RouteType route;
+        SplitInfo split;
+        RouteTimeWindows tw;
+    };
+
+    std::vector<RouteEntry> m_entries;  ///< recorded routes
+    size_t m_routes_count = 0;  ///< number of routes at transaction start
+    size_t m_tw_count = 0;      ///< number of time window segments at
+                                ///< transaction start
+    bool m_active = false;      ///< whether transaction is started
+
+public:
+    /// Start transaction on solution
+    void begin(const Solution& sln);
+
+    /// Record route before it is changed. Repeated records of the same route
+    /// within a transaction are ignored
+    void record_route(const Solution& sln, size_t route_index);
+
+    /// Accept changes made since transaction start
+    void commit();
+
+    /// Revert changes made since transaction start
+    void rollback(Solution& sln);
+
+    inline bool active() const noexcept { return m_active; }
+};
 }  // namespace vrp
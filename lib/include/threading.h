@@ -1,6 +1,14 @@
 #pragma once
 
+#include <algorithm>
+#include <condition_variable>
 #include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <type_traits>
 #include <utility>
 
 #if USE_TBB
@@ -9,6 +17,92 @@
 
 namespace vrp {
 namespace threading {
+/// Set number of worker threads of the default pool. 0 means number of
+/// hardware threads. Must not be called while parallel algorithms run: the
+/// pool is re-created on next use
+void set_workers_count(size_t count);
+
+/// Get number of worker threads of the default pool
+size_t workers_count();
+
+/// Work-stealing thread pool. Each worker owns a task queue: it takes tasks
+/// from the back of its own queue and steals from the front of the others
+class ThreadPool {
+    struct Impl;
+    std::unique_ptr<Impl> m_impl;
+
+public:
+    using Task = std::function<void()>;
+
+    explicit ThreadPool(size_t workers);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /// number of worker threads
+    size_t size() const noexcept;
+
+    /// schedule task for execution
+    void push(Task task);
+
+    /// execute one scheduled task in the calling thread. returns false if
+    /// there was nothing to execute
+    bool run_pending_task();
+
+    /// schedule callable for execution, its result is available via future.
+    /// do not block on the future inside pool tasks: use TaskGroup instead
+    template<typename Callable>
+    std::future<std::result_of_t<Callable()>> submit(Callable f) {
+        using result_t = std::result_of_t<Callable()>;
+        auto task =
+            std::make_shared<std::packaged_task<result_t()>>(std::move(f));
+        auto future = task->get_future();
+        push([task]() { (*task)(); });
+        return future;
+    }
+};
+
+/// Get pool shared by parallel algorithms
+ThreadPool& default_pool();
+
+/// Group of tasks that can be waited for. Waiting thread executes scheduled
+/// tasks as well, so groups can be nested within pool tasks
+class TaskGroup {
+    ThreadPool& m_pool;
+    size_t m_pending = 0;  ///< number of unfinished tasks
+    std::exception_ptr m_error = nullptr;  ///< first exception thrown by task
+    std::mutex m_mutex;
+    std::condition_variable m_done;
+
+    void finish(std::exception_ptr error);
+
+public:
+    explicit TaskGroup(ThreadPool& pool = default_pool());
+    ~TaskGroup();
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    /// schedule callable for execution within the group
+    template<typename Callable> void run(Callable f) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            ++m_pending;
+        }
+        m_pool.push([this, f = std::move(f)]() mutable {
+            std::exception_ptr error = nullptr;
+            try {
+                f();
+            } catch (...) {
+                error = std::current_exception();
+            }
+            finish(error);
+        });
+    }
+
+    /// wait for all tasks of the group. rethrows first exception thrown by a
+    /// task
+    void wait();
+};
 
 // use TBB in release mode only
 #if USE_TBB && defined(NDEBUG)
@@ -23,16 +117,71 @@ void parallel_range(T iters, Callable f) {
         tbb::blocked_range<T>(T(0), iters),
         [&](const auto& range) { f(range.begin(), range.end()); });
 }
+
+template<typename T, typename Callable>
+void parallel_tasks(T iters, Callable f) {
+    tbb::parallel_for(T(0), iters, [&](T i) { f(i); },
+                      tbb::simple_partitioner{});
+}
 #else
-template<typename T, typename Callable> void parallel_for(T iters, Callable f) {
-    for (T i = 0; i < iters; ++i) {
-        f(i);
+namespace detail {
+/// split [0, iters) into chunks executed by default pool
+template<typename T, typename Callable>
+void parallel_chunks(T iters, const Callable& f) {
+    if (iters <= T(0)) {
+        return;
     }
+    auto& pool = default_pool();
+    const size_t size = static_cast<size_t>(iters);
+    if (pool.size() < 2 || size < 2) {
+        f(T(0), iters);
+        return;
+    }
+
+    // several chunks per worker to balance uneven work
+    const size_t chunks = std::min(size, 4 * pool.size());
+    const size_t chunk_size = (size + chunks - 1) / chunks;
+    TaskGroup group(pool);
+    for (size_t first = 0; first < size; first += chunk_size) {
+        const size_t last = std::min(size, first + chunk_size);
+        group.run([&f, first, last]() { f(T(first), T(last)); });
+    }
+    group.wait();
+}
+}  // namespace detail
+
+template<typename T, typename Callable> void parallel_for(T iters, Callable f) {
+    detail::parallel_chunks(iters, [&f](T first, T last) {
+        for (; first != last; ++first) {
+            f(first);
+        }
+    });
 }
 
 template<typename T, typename Callable>
 void parallel_range(T iters, Callable f) {
-    f(T(0), iters);
+    detail::parallel_chunks(iters, f);
+}
+
+/// run each iteration as a separate task: suited for few iterations of very
+/// different duration, as idle workers steal the remaining ones one by one
+template<typename T, typename Callable>
+void parallel_tasks(T iters, Callable f) {
+    if (iters <= T(0)) {
+        return;
+    }
+    auto& pool = default_pool();
+    if (pool.size() < 2 || iters < T(2)) {
+        for (T i = T(0); i != iters; ++i) {
+            f(i);
+        }
+        return;
+    }
+    TaskGroup group(pool);
+    for (T i = T(0); i != iters; ++i) {
+        group.run([&f, i]() { f(i); });
+    }
+    group.wait();
 }
 #endif
 }  // namespace threading
@@ -0,0 +1,21 @@
+#pragma once
+
+namespace vrp {
+namespace time_budget {
+/// Set wall-clock time limit of the solve, counted from the moment of the
+/// call. Non-positive value disables the limit
+void set_time_limit(double seconds);
+
+/// Clear time limit and stop request, e.g. between consecutive solves
+void reset() noexcept;
+
+/// Request to stop the solve as soon as possible. Async-signal-safe: can be
+/// called from signal handlers
+void request_stop() noexcept;
+
+/// Check whether the solve should stop: time limit expired or stop was
+/// requested. Long-running stages poll this and return best results found so
+/// far
+bool expired() noexcept;
+}  // namespace time_budget
+}  // namespace vrp
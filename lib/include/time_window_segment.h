@@ -0,0 +1,59 @@
+#pragma once
+
+#include <algorithm>
+#include <limits>
+
+namespace vrp {
+/// Time window segment: constant size summary of a route part
+/*!
+ * Times are expressed as functions of arrival time `a` at the first node of
+ * the part: service at the last node finishes at max(a + duration, earliest),
+ * and no extra time window violation occurs while a <= latest. This allows to
+ * check time windows of concatenated route parts with a constant number of
+ * operations instead of a full route scan
+ */
+struct TimeWindowSegment {
+    int duration = 0;  ///< service and travel time, excluding waiting
+    int earliest = 0;  ///< earliest finish time at the last node
+    int latest = std::numeric_limits<int>::max();  ///< latest arrival at the
+                                                   /// first node that doesn't
+                                                   /// violate time windows
+    int violated_time = 0;  ///< violated time when the part is started as
+                            /// early as possible. exact for segments extended
+                            /// node by node from the route part start,
+                            /// otherwise only zero-ness is exact
+
+    /// Segment of the node a route part starts with: service starts at 0 and
+    /// node's time window is not checked
+    static inline TimeWindowSegment start(int service_time) noexcept {
+        return {service_time, service_time, std::numeric_limits<int>::max(),
+                0};
+    }
+
+    /// Segment of a regular node
+    static inline TimeWindowSegment node(int tw_begin, int tw_end,
+                                         int service_time) noexcept {
+        return {service_time, tw_begin + service_time, tw_end - service_time,
+                std::max(0, tw_begin + service_time - tw_end)};
+    }
+
+    /// Returns whether time windows are satisfied within the part
+    inline bool satisfies_time_windows() const noexcept {
+        return violated_time == 0;
+    }
+};
+
+/// Concatenate route parts: lhs, travel from lhs last node to rhs first node,
+/// rhs
+inline TimeWindowSegment concatenate(const TimeWindowSegment& lhs, int travel,
+                                     const TimeWindowSegment& rhs) noexcept {
+    const int arrival = lhs.earliest + travel;
+    TimeWindowSegment result;
+    result.duration = lhs.duration + travel + rhs.duration;
+    result.earliest = std::max(arrival + rhs.duration, rhs.earliest);
+    result.latest = std::min(lhs.latest, rhs.latest - lhs.duration - travel);
+    result.violated_time = lhs.violated_time + rhs.violated_time +
+                           std::max(0, arrival - rhs.latest);
+    return result;
+}
+}  // namespace vrp
@@ -0,0 +1,365 @@
+#include "binary_parser.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define VRP_USE_MMAP 1
+#else
+#define VRP_USE_MMAP 0
+#endif
+
+namespace {
+constexpr const char magic[8] = {'V', 'R', 'P', 'B', 'I', 'N', '\0', '\0'};
+constexpr const uint32_t byte_order_mark = 0x01020304;
+constexpr const uint64_t section_alignment = vrp::CostMatrix::alignment;
+
+/// File header
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;  ///< byte_order_mark in native byte order
+    uint32_t cost_size;   ///< size of cost matrix value: float or double
+    int32_t max_violated_soft_tw;
+    int32_t max_splits;
+    uint32_t reserved;
+    uint64_t n_customers;
+    uint64_t n_vehicles;
+    uint64_t n_suitable;  ///< total number of suitable vehicles
+    uint64_t customers;   ///< offset of customers section
+    uint64_t vehicles;    ///< offset of vehicles section
+    uint64_t suitable;    ///< offset of suitable vehicles section
+    uint64_t costs;       ///< offset of cost matrix
+    uint64_t times;       ///< offset of time matrix
+    uint64_t file_size;
+};
+
+/// Customer record
+struct CustomerRecord {
+    int32_t id;
+    int32_t volume;
+    int32_t weight;
+    int32_t hard_tw_begin;
+    int32_t hard_tw_end;
+    int32_t soft_tw_begin;
+    int32_t soft_tw_end;
+    int32_t service_time;
+    uint64_t suitable_first;  ///< index of first suitable vehicle
+    uint64_t suitable_size;   ///< number of suitable vehicles
+};
+
+/// Vehicle record
+struct VehicleRecord {
+    int32_t id;
+    int32_t volume;
+    int32_t weight;
+    int32_t reserved;
+    double fixed_cost;
+    double variable_cost;
+};
+
+static_assert(std::is_trivially_copyable<Header>::value &&
+                  std::is_trivially_copyable<CustomerRecord>::value &&
+                  std::is_trivially_copyable<VehicleRecord>::value,
+              "binary records must be trivially copyable");
+
+inline uint64_t align(uint64_t offset) {
+    return (offset + section_alignment - 1) / section_alignment *
+           section_alignment;
+}
+
+/// Read-only view of the whole file, kept alive by matrices that use it
+class MappedFile {
+    unsigned char* m_data = nullptr;
+    size_t m_size = 0;
+#if !VRP_USE_MMAP
+    std::unique_ptr<unsigned char[]> m_buffer;
+#endif
+
+    static void fail(const std::string& path, const std::string& what) {
+        std::stringstream ss;
+        ss << "cannot read binary file '" << path << "': " << what;
+        throw std::runtime_error(ss.str());
+    }
+
+public:
+    explicit MappedFile(const std::string& path) {
+#if VRP_USE_MMAP
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            fail(path, "open failed");
+        }
+        struct stat info = {};
+        if (::fstat(fd, &info) != 0) {
+            ::close(fd);
+            fail(path, "stat failed");
+        }
+        m_size = static_cast<size_t>(info.st_size);
+        if (m_size != 0) {
+            // private mapping: writes to the matrices never reach the file
+            void* data = ::mmap(nullptr, m_size, PROT_READ | PROT_WRITE,
+                                MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED) {
+                ::close(fd);
+                fail(path, "mmap failed");
+            }
+            m_data = static_cast<unsigned char*>(data);
+        }
+        ::close(fd);
+#else
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in.good()) {
+            fail(path, "open failed");
+        }
+        m_size = static_cast<size_t>(in.tellg());
+        m_buffer.reset(new unsigned char[m_size]);
+        m_data = m_buffer.get();
+        in.seekg(0);
+        in.read(reinterpret_cast<char*>(m_data), m_size);
+        if (!in.good()) {
+            fail(path, "read failed");
+        }
+#endif
+    }
+
+    ~MappedFile() {
+#if VRP_USE_MMAP
+        if (m_data) {
+            ::munmap(m_data, m_size);
+        }
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    unsigned char* data() const noexcept { return m_data; }
+    size_t size() const noexcept { return m_size; }
+};
+
+/// Check that section [offset, offset + size) lies within the file
+void check_section(const Header& header, uint64_t offset, uint64_t size,
+                   const char* name) {
+    if (offset % section_alignment != 0 || offset > header.file_size ||
+        size > header.file_size - offset) {
+        std::stringstream ss;
+        ss << "binary file: section " << name << " is out of file bounds";
+        throw std::runtime_error(ss.str());
+    }
+}
+
+/// Build cost matrix from file values of different precision
+template<typename FileCostType>
+vrp::CostMatrix convert_costs(const unsigned char* first, size_t size) {
+    vrp::CostMatrix costs(size, size);
+    for (size_t i = 0, n = size * size; i < n; ++i) {
+        FileCostType value = 0;
+        std::memcpy(&value, first + i * sizeof(FileCostType), sizeof(value));
+        costs.data()[i] = static_cast<vrp::CostType>(value);
+    }
+    return costs;
+}
+
+void write_padding(std::ostream& out, uint64_t& offset, uint64_t to) {
+    static const char zeros[section_alignment] = {};
+    out.write(zeros, static_cast<std::streamsize>(to - offset));
+    offset = to;
+}
+
+template<typename T>
+void write_values(std::ostream& out, uint64_t& offset, const T* values,
+                  size_t size) {
+    out.write(reinterpret_cast<const char*>(values),
+              static_cast<std::streamsize>(size * sizeof(T)));
+    offset += size * sizeof(T);
+}
+}  // namespace
+
+namespace vrp {
+constexpr const uint32_t BinaryParser::version;
+
+bool BinaryParser::is_binary(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    char file_magic[sizeof(magic)] = {};
+    in.read(file_magic, sizeof(file_magic));
+    return in.good() &&
+           std::equal(std::begin(magic), std::end(magic), file_magic);
+}
+
+Problem BinaryParser::read(const std::string& path) const {
+    auto file = std::make_shared<MappedFile>(path);
+    const unsigned char* first = file->data();
+
+    Header header = {};
+    if (file->size() < sizeof(header)) {
+        throw std::runtime_error("binary file: header is truncated");
+    }
+    std::memcpy(&header, first, sizeof(header));
+    if (!std::equal(std::begin(magic), std::end(magic), header.magic)) {
+        throw std::runtime_error("binary file: wrong magic");
+    }
+    if (header.version != version) {
+        std::stringstream ss;
+        ss << "binary file: unsupported version " << header.version
+           << ", expected " << version;
+        throw std::runtime_error(ss.str());
+    }
+    if (header.byte_order != byte_order_mark) {
+        throw std::runtime_error("binary file: byte order mismatch");
+    }
+    if (header.cost_size != sizeof(float) &&
+        header.cost_size != sizeof(double)) {
+        throw std::runtime_error("binary file: unsupported cost value size");
+    }
+    if (header.file_size != file->size()) {
+        throw std::runtime_error("binary file: size mismatch");
+    }
+
+    const uint64_t n = header.n_customers;
+    if (n != 0 && n > header.file_size / n) {
+        throw std::runtime_error("binary file: wrong number of customers");
+    }
+    check_section(header, header.customers, n * sizeof(CustomerRecord),
+                  "customer");
+    check_section(header, header.vehicles,
+                  header.n_vehicles * sizeof(VehicleRecord), "vehicle");
+    check_section(header, header.suitable, header.n_suitable * sizeof(int32_t),
+                  "suitable vehicles");
+    check_section(header, header.costs, n * n * header.cost_size, "cost");
+    check_section(header, header.times, n * n * sizeof(TimeType), "time");
+
+    Problem problem = {};
+    problem.max_violated_soft_tw = header.max_violated_soft_tw;
+    problem.max_splits = std::max(problem.max_splits, header.max_splits);
+
+    const auto* suitable =
+        reinterpret_cast<const int32_t*>(first + header.suitable);
+    problem.customers.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        CustomerRecord record = {};
+        std::memcpy(&record, first + header.customers + i * sizeof(record),
+                    sizeof(record));
+        if (record.suitable_first > header.n_suitable ||
+            record.suitable_size > header.n_suitable - record.suitable_first) {
+            throw std::runtime_error(
+                "binary file: suitable vehicles are out of bounds");
+        }
+        auto& customer = problem.customers[i];
+        customer.id = record.id;
+        customer.demand = {record.volume, record.weight};
+        customer.hard_tw = {record.hard_tw_begin, record.hard_tw_end};
+        customer.soft_tw = {record.soft_tw_begin, record.soft_tw_end};
+        customer.service_time = record.service_time;
+        customer.suitable_vehicles.assign(
+            suitable + record.suitable_first,
+            suitable + record.suitable_first + record.suitable_size);
+    }
+
+    problem.vehicles.resize(header.n_vehicles);
+    for (size_t i = 0; i < header.n_vehicles; ++i) {
+        VehicleRecord record = {};
+        std::memcpy(&record, first + header.vehicles + i * sizeof(record),
+                    sizeof(record));
+        auto& vehicle = problem.vehicles[i];
+        vehicle.id = record.id;
+        vehicle.capacity = {record.volume, record.weight};
+        vehicle.fixed_cost = record.fixed_cost;
+        vehicle.variable_cost = record.variable_cost;
+    }
+
+    // matrices use mapped memory in place if value types match
+    auto* data = file->data();
+    if (header.cost_size == sizeof(CostType)) {
+        problem.costs = CostMatrix(
+            reinterpret_cast<CostType*>(data + header.costs), n, n, file);
+    } else if (header.cost_size == sizeof(float)) {
+        problem.costs = convert_costs<float>(data + header.costs, n);
+    } else {
+        problem.costs = convert_costs<double>(data + header.costs, n);
+    }
+    problem.times = TimeMatrix(reinterpret_cast<TimeType*>(data + header.times),
+                               n, n, file);
+
+    problem.set_up();
+    return problem;
+}
+
+void BinaryParser::write(std::ostream& out, const Problem& prob) const {
+    const uint64_t n = prob.n_customers();
+    if (prob.costs.rows() != n || prob.costs.cols() != n ||
+        prob.times.rows() != n || prob.times.cols() != n) {
+        throw std::runtime_error(
+            "matrix size does not match the number of customers");
+    }
+
+    std::vector<CustomerRecord> customers(n);
+    std::vector<int32_t> suitable = {};
+    for (size_t i = 0; i < n; ++i) {
+        const auto& c = prob.customers[i];
+        customers[i] = {c.id,
+                        c.demand.volume,
+                        c.demand.weight,
+                        c.hard_tw.first,
+                        c.hard_tw.second,
+                        c.soft_tw.first,
+                        c.soft_tw.second,
+                        c.service_time,
+                        suitable.size(),
+                        c.suitable_vehicles.size()};
+        suitable.insert(suitable.end(), c.suitable_vehicles.cbegin(),
+                        c.suitable_vehicles.cend());
+    }
+
+    std::vector<VehicleRecord> vehicles(prob.n_vehicles());
+    for (size_t i = 0; i < vehicles.size(); ++i) {
+        const auto& v = prob.vehicles[i];
+        vehicles[i] = {v.id,          v.capacity.volume, v.capacity.weight, 0,
+                       v.fixed_cost, v.variable_cost};
+    }
+
+    Header header = {};
+    std::copy(std::begin(magic), std::end(magic), header.magic);
+    header.version = version;
+    header.byte_order = byte_order_mark;
+    header.cost_size = sizeof(CostType);
+    header.max_violated_soft_tw = prob.max_violated_soft_tw;
+    header.max_splits = prob.max_splits;
+    header.n_customers = n;
+    header.n_vehicles = vehicles.size();
+    header.n_suitable = suitable.size();
+    header.customers = align(sizeof(Header));
+    header.vehicles = align(header.customers + n * sizeof(CustomerRecord));
+    header.suitable =
+        align(header.vehicles + vehicles.size() * sizeof(VehicleRecord));
+    header.costs = align(header.suitable + suitable.size() * sizeof(int32_t));
+    header.times = align(header.costs + n * n * sizeof(CostType));
+    header.file_size = header.times + n * n * sizeof(TimeType);
+
+    uint64_t offset = 0;
+    write_values(out, offset, &header, 1);
+    write_padding(out, offset, header.customers);
+    write_values(out, offset, customers.data(), customers.size());
+    write_padding(out, offset, header.vehicles);
+    write_values(out, offset, vehicles.data(), vehicles.size());
+    write_padding(out, offset, header.suitable);
+    write_values(out, offset, suitable.data(), suitable.size());
+    write_padding(out, offset, header.costs);
+    write_values(out, offset, prob.costs.data(), prob.costs.size());
+    write_padding(out, offset, header.times);
+    write_values(out, offset, prob.times.data(), prob.times.size());
+
+    if (!out.good()) {
+        throw std::runtime_error("failed to write binary problem");
+    }
+}
+}  // namespace vrp
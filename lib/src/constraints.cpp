@@ -160,7 +160,7 @@ bool satisfies_split_delivery_impl(const Problem& prob, const Solution& sln,
                 continue;
             }
 
-            if (p.second != 1.0) {
+            if (!p.second.whole()) {
                 return false;
             }
         }
@@ -173,12 +173,12 @@ bool satisfies_split_delivery(const Problem& prob, const Solution& sln) {
     // verify split info is correct
     if (prob.enable_splits()) {
         const auto ratio_checker = [](const SplitInfo::Ratio& r) {
-            return r > 0.0 && r <= 1.0;
+            return r.units > 0 && r.units <= r.total;
         };
         return satisfies_split_delivery_impl<true>(prob, sln, ratio_checker);
     } else {
         const auto ratio_checker = [](const SplitInfo::Ratio& r) {
-            return r == 1.0;
+            return r.whole();
         };
         return satisfies_split_delivery_impl<false>(prob, sln, ratio_checker);
     }
@@ -14,45 +14,76 @@ namespace {
 /// Specifies unused variable
 #define UNUSED(x) (void)x;
 
-/// Checks whether given string is a supported type specifier
-bool type_specifier(std::string& line) {
+using vrp::detail::TextRange;
+
+/// Checks whether given line is a supported type specifier
+bool type_specifier(TextRange& line) {
     static std::vector<std::string> supported_types = {"table", "value"};
     for (const auto& type : supported_types) {
-        if (line.length() >= 5 && std::equal(line.cbegin(), line.cbegin() + type.size(),
-                       type.cbegin())) {
-            // remove type specifier from string
-            line = {line.begin() + type.size() + 1, line.end()};
+        if (line.size() >= 5 && line.size() >= type.size() &&
+            std::equal(type.cbegin(), type.cend(), line.first)) {
+            // remove type specifier from line
+            line.first += std::min(type.size() + 1, line.size());
             return true;
         }
     }
     return false;
 }
 
+/// Reads whole stream into single buffer
+std::string read_buffer(std::istream& stream) {
+    std::string buffer = {};
+    const auto first = stream.tellg();
+    if (first != std::istream::pos_type(-1) && stream.seekg(0, std::ios::end)) {
+        const auto last = stream.tellg();
+        stream.seekg(first);
+        buffer.resize(static_cast<size_t>(last - first));
+        stream.read(&buffer[0], static_cast<std::streamsize>(buffer.size()));
+        buffer.resize(static_cast<size_t>(stream.gcount()));
+        return buffer;
+    }
+    // stream is not seekable
+    stream.clear();
+    std::stringstream ss;
+    ss << stream.rdbuf();
+    return ss.str();
+}
+
+/// File content: single buffer and its non-empty lines
+struct FileContent {
+    std::string buffer = {};
+    std::vector<TextRange> lines = {};
+    std::map<std::string, std::pair<uint64_t, uint64_t>> data_ranges = {};
+};
+
 /// Reads file content into memory
-std::pair<std::vector<std::string>,
-          std::map<std::string, std::pair<uint64_t, uint64_t>>>
-read_file(std::istream& stream) {
-    std::vector<std::string> content = {};
+FileContent read_file(std::istream& stream) {
+    FileContent content = {};
+    content.buffer = read_buffer(stream);
     std::vector<std::pair<std::string, uint64_t>> table_lines = {};
-    std::string line = "";
-    uint64_t line_number = 0;
-    while (!stream.eof()) {
-        std::getline(stream, line);
+    const char* first = content.buffer.data();
+    const char* const end = first + content.buffer.size();
+    while (first != end) {
+        const char* last = std::find(first, end, '\n');
+        TextRange line = {first, last};
+        first = (last == end) ? end : last + 1;
+        if (!line.empty() && *(line.last - 1) == '\r') {
+            --line.last;
+        }
         if (line.empty())
             continue;
         if (type_specifier(line)) {
-            table_lines.push_back(std::make_pair(line, line_number));
+            table_lines.push_back(
+                std::make_pair(line.str(), content.lines.size()));
         }
-        content.push_back(std::move(line));
-        line_number++;
+        content.lines.push_back(line);
     }
-    table_lines.push_back(std::make_pair("_", content.size()));
-    std::map<std::string, std::pair<uint64_t, uint64_t>> data_ranges = {};
+    table_lines.push_back(std::make_pair("_", content.lines.size()));
     for (size_t i = 0; i < table_lines.size() - 1; ++i) {
-        data_ranges[table_lines[i].first] =
+        content.data_ranges[table_lines[i].first] =
             std::make_pair(table_lines[i].second, table_lines[i + 1].second);
     }
-    return std::make_pair(content, data_ranges);
+    return content;
 }
 
 /// Checks that all tables have corresponding range
@@ -81,9 +112,9 @@ namespace vrp {
 CsvParser::CsvParser(char delimiter) : m_delimiter(delimiter) {}
 
 Problem CsvParser::read(std::istream& in) const {
-    auto read_data = read_file(in);
-    auto& content = read_data.first;
-    auto& data_ranges = read_data.second;
+    const auto file = read_file(in);
+    const auto& content = file.lines;
+    const auto& data_ranges = file.data_ranges;
     check_all_values_exist({detail::CustomerTableParser::table_name,
                             detail::VehicleTableParser::table_name,
                             detail::CostTableParser::table_name,
@@ -136,16 +167,9 @@ void CsvParser::write(std::ostream& out, const Problem& prob,
 
     char del = this->m_delimiter;
 
-    static const auto at = [](const auto& list, size_t i) {
-        if (list.size() <= i) {
-            throw std::out_of_range("index out of list's range");
-        }
-        return *std::next(list.begin(), i);
-    };
-
     // calculate distance from customer (i - 1) to customer i
     auto prev_dist = [&prob](const auto& route, size_t i) {
-        return prob.costs[at(route.second, i - 1)][at(route.second, i)];
+        return prob.costs(route.second[i - 1], route.second[i]);
     };
 
     assert(sln.routes.size() == sln.times.size());
@@ -156,11 +180,11 @@ void CsvParser::write(std::ostream& out, const Problem& prob,
         assert(route.second.size() == time.second.size());
         // node with j == 0 is a depot
         for (size_t j = 1; j < route.second.size() - 1; ++j) {
-            auto c = at(route.second, j);  // customer
+            auto c = route.second[j];  // customer
 
             out << i << del << route.first << del << c << del;
-            out << at(time.second, j);
-            out << prev_dist(route, j) << del << prob.costs[c][0] << "\n";
+            out << time.second[j];
+            out << prev_dist(route, j) << del << prob.costs(c, 0) << "\n";
         }
     }
 }
@@ -5,10 +5,11 @@
 namespace vrp {
 Solution create_improved_solution(const Problem& prob,
                                   const Solution& initial_sln,
-                                  ImprovementHeuristic heuristic) {
+                                  ImprovementHeuristic heuristic,
+                                  SharedIncumbent* incumbent) {
     switch (heuristic) {
     case ImprovementHeuristic::Tabu:
-        return detail::tabu_search(prob, initial_sln);
+        return detail::tabu_search(prob, initial_sln, incumbent);
     default:
         return initial_sln;
     }
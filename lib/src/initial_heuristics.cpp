@@ -3,19 +3,22 @@
 #include "src/internal/cluster_first_route_second.h"
 #include "src/internal/savings.h"
 
+#include <algorithm>
+
 namespace vrp {
 namespace {
-// TODO: fix this somehow later - this introduces quite an overhead
-std::vector<Solution> fill_splits(const Problem& prob,
-                                  std::vector<Solution>&& slns, bool fill) {
+std::vector<Solution> fill_splits(std::vector<Solution>&& slns, bool fill) {
+    // heuristics leave solutions empty once time budget expires
+    slns.erase(std::remove_if(slns.begin(), slns.end(),
+                              [](const Solution& sln) {
+                                  return sln.routes.empty();
+                              }),
+               slns.end());
     if (!fill) {
         return slns;
     }
 
-    SplitInfo full_info = {};
-    for (size_t c = 0, size = prob.n_customers(); c < size; ++c) {
-        full_info.split_info[c] = 1.0;
-    }
+    const auto full_info = SplitInfo::all_customers();
     for (auto& sln : slns) {
         sln.route_splits.resize(sln.routes.size(), full_info);
     }
@@ -29,15 +32,13 @@ std::vector<Solution> create_initial_solutions(const Problem& prob,
     const bool fill_with_default = !prob.enable_splits();
     switch (heuristic) {
     case InitialHeuristic::Savings:
-        return fill_splits(prob, detail::savings(prob, count),
-                           fill_with_default);
+        return fill_splits(detail::savings(prob, count), fill_with_default);
     case InitialHeuristic::Insertion:
         return {};
     case InitialHeuristic::ParallelInsertion:
         return {};
     case InitialHeuristic::ClusterFirstRouteSecond:
-        return fill_splits(prob,
-                           detail::cluster_first_route_second(prob, count),
+        return fill_splits(detail::cluster_first_route_second(prob, count),
                            fill_with_default);
     default:
         return {};
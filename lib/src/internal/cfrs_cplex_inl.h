@@ -1,5 +1,7 @@
 #include "constraints.h"
 #include "logging.h"
+#include "threading.h"
+#include "time_budget.h"
 
 #include <algorithm>
 #include <cassert>
@@ -515,28 +517,34 @@ std::vector<double> fix_ratios(const TransportationQuantity& demand,
     return fixed_ratios;
 }
 
+/// Groups of customers per vehicle type and split info per customer
+using groups_t = std::pair<std::unordered_map<size_t, std::list<size_t>>,
+                           std::unordered_map<size_t, SplitInfo>>;
+
 /// Get non-constructed groups of customers that belong to the same routes
-std::pair<std::unordered_map<size_t, std::list<size_t>>,
-          std::unordered_map<size_t, SplitInfo>>
-group(const Heuristic& h, size_t depot_offset) {
+groups_t group(const Heuristic& h, size_t depot_offset) {
     auto assignment_map = h.get_values();
     std::unordered_map<size_t, std::list<size_t>> routes;
     std::unordered_map<size_t, SplitInfo> splits;
     for (size_t c = 0; c < assignment_map.size(); ++c) {
-        auto ratios = fix_ratios(h.prob().customers[c + depot_offset].demand,
-                                 assignment_map[c]);
+        const auto& customer = h.prob().customers[c + depot_offset];
+        auto ratios = fix_ratios(customer.demand, assignment_map[c]);
         for (size_t t = 0; t < ratios.size(); ++t) {
             if (ratios[t] == 0.0) {
                 continue;
             }
             routes[t].emplace_back(c + depot_offset);
-            splits[c + depot_offset].split_info[t] = ratios[t];
+            // ratios are aligned to demand volume: convert them to units
+            const auto units = static_cast<int>(std::lround(
+                ratios[t] * SplitInfo::Ratio::total_units(customer)));
+            splits[c + depot_offset].split_info[t] = SplitInfo::Split(
+                customer, SplitInfo::Ratio::of(customer, units));
         }
     }
     return std::make_pair(routes, splits);
 }
 
-template<typename T> using mat_t = std::vector<std::vector<T>>;
+template<typename T> using mat_t = Matrix<T>;
 
 template<typename T, typename ListIt>
 T sum_route_part(const mat_t<T>& mat, ListIt first, ListIt last) {
@@ -550,6 +558,8 @@ T sum_route_part(const mat_t<T>& mat, ListIt first, ListIt last) {
 #define EXPERIMENTAL 1
 
 constexpr const double VRP_RANDOMNESS_THRESHOLD = 0.8;
+// base seed of randomized constructions
+constexpr const uint32_t CFRS_BASE_SEED = 5489u;
 
 std::tuple<TransportationQuantity, double, double>
 get_statistics(const Problem& prob) {
@@ -586,14 +596,14 @@ get_statistics(const Problem& prob) {
     return std::make_tuple(max_capacity, max_fixed_cost, max_variable_cost);
 }
 
-/// Solve basic (capacitated) VRP with insertion heuristic
+/// Solve basic (capacitated) VRP with insertion heuristic. Customers are
+/// skipped randomly if random number generator is provided
 std::pair<std::vector<std::tuple<size_t, size_t, std::list<size_t>>>,
           std::unordered_map<size_t, SplitInfo>>
-solve_vrp(const Heuristic& h, bool random = false) {
-    std::unordered_map<size_t, std::list<size_t>> typed_customers;
-    std::unordered_map<size_t, SplitInfo> customer_splits;
-    // depot_offset = 1 due to depot at index 0:
-    std::tie(typed_customers, customer_splits) = group(h, 1);
+solve_vrp(const Heuristic& h, const groups_t& groups,
+          std::mt19937* random = nullptr) {
+    auto typed_customers = groups.first;
+    auto customer_splits = groups.second;
 
     const auto& prob = h.prob();
     static constexpr const size_t depot = 0;
@@ -623,8 +633,7 @@ solve_vrp(const Heuristic& h, bool random = false) {
                (fraction.volume + fraction.weight);
     };
 
-    static std::mt19937 g;
-    static std::uniform_real_distribution<> dist(0.0, 1.0);
+    std::uniform_real_distribution<> dist(0.0, 1.0);
 
     std::unordered_map<size_t, SplitInfo> splits_by_vehicles;
 
@@ -667,12 +676,11 @@ solve_vrp(const Heuristic& h, bool random = false) {
                     // skip if capacity is exceeded
                     if (!last_vehicle &&
                         running_capacity <
-                            prob.customers[c].demand *
-                                customer_splits[c].split_info[t]) {
+                            customer_splits[c].split_info[t].demand) {
                         continue;
                     }
                     if (!last_vehicle && random &&
-                        dist(g) > VRP_RANDOMNESS_THRESHOLD) {
+                        dist(*random) > VRP_RANDOMNESS_THRESHOLD) {
                         continue;
                     }
                     std::list<double> ratings_c2{};
@@ -760,8 +768,7 @@ solve_vrp(const Heuristic& h, bool random = false) {
                 route = std::move(updated_route);
                 assert(route.size() > 2);
 
-                running_capacity -=
-                    prob.customers[c].demand * customer_splits[c].split_info[t];
+                running_capacity -= customer_splits[c].split_info[t].demand;
                 nothing_to_add = false;
 
                 // convert types to vehicles in SplitInfo
@@ -802,7 +809,9 @@ Solution routes_to_sln(
     std::unordered_map<size_t, SplitInfo> splits_by_routes;
     for (auto& values : routes) {
         const size_t vehicle = std::get<1>(values);
-        sln.routes.emplace_back(vehicle, std::move(std::get<2>(values)));
+        const auto& route = std::get<2>(values);
+        sln.routes.emplace_back(
+            vehicle, Solution::RouteType(route.cbegin(), route.cend()));
 
         // convert vehicles to routes in SplitInfo
         const size_t rid = sln.routes.size() - 1;  // always last inserted route
@@ -846,7 +855,8 @@ select_seeds(const Heuristic& h) {
 
     // the customer on the route with the largest seed weight becomes the seed
     // point of the route
-    auto routes = solve_vrp(h).first;  // TODO: can ignore splits here?
+    // depot_offset = 1 due to depot at index 0:
+    auto routes = solve_vrp(h, group(h, 1)).first;  // TODO: can ignore splits here?
     // TODO: in fact, we don't need routes...
     for (auto& vehicle_route : routes) {
         auto& route = std::get<2>(vehicle_route);
@@ -892,11 +902,21 @@ select_seeds(const Heuristic& h) {
 
 std::vector<Solution> construct_solutions(const Heuristic& h, size_t count) {
     const bool solve_randomly = count > 1;
+    // query CPLEX once: constructions only read the groups and run in parallel
+    const auto groups = group(h, 1);
     std::vector<Solution> solutions(count);
-    for (size_t i = 0, size = solutions.size(); i < size; ++i) {
-        solutions[i] = std::move(
-            routes_to_sln(h.prob(), solve_vrp(h, i && solve_randomly)));
-    }
+    threading::parallel_for(count, [&](size_t i) {
+        // first solution is always built: there's a result to return
+        if (i != 0 && time_budget::expired()) {
+            return;
+        }
+        // each construction has own seed derived from the base one, so the
+        // result does not depend on the order of execution
+        std::seed_seq seq{CFRS_BASE_SEED, static_cast<uint32_t>(i)};
+        std::mt19937 g(seq);
+        solutions[i] = std::move(routes_to_sln(
+            h.prob(), solve_vrp(h, groups, i && solve_randomly ? &g : nullptr)));
+    });
     return solutions;
 }
 }  // namespace
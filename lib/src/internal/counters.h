@@ -0,0 +1,106 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace vrp {
+namespace perf {
+/// Local search operators with counters
+enum class Operator : size_t {
+    Relocate = 0,
+    Exchange,
+    TwoOpt,
+    Cross,
+    RelocateNewRoute,
+    RelocateSplit,
+    RouteSave,
+    IntraRelocate,
+    MergeSplits,
+    Last
+};
+
+/// Outcomes of evaluated moves. Each evaluated move has exactly one outcome
+/// apart from Evaluated
+enum class Outcome : size_t {
+    Evaluated = 0,
+    Accepted,
+    RejectedTabu,  ///< tabu and not accepted by aspiration criteria
+    RejectedCapacity,
+    RejectedTimeWindows,
+    NotImproving,
+    Last
+};
+
+constexpr const size_t OPERATORS_COUNT = static_cast<size_t>(Operator::Last);
+constexpr const size_t OUTCOMES_COUNT = static_cast<size_t>(Outcome::Last);
+
+/// Counters of a single thread. Only the owning thread writes them
+struct Counters {
+    std::array<std::array<uint64_t, OUTCOMES_COUNT>, OPERATORS_COUNT> moves{};
+    std::array<uint64_t, OPERATORS_COUNT> calls{};        ///< operator calls
+    std::array<uint64_t, OPERATORS_COUNT> nanoseconds{};  ///< operator time
+    uint64_t tabu_iterations = 0;   ///< number of tabu search iterations
+    uint64_t tabu_nanoseconds = 0;  ///< time of tabu search iterations
+};
+
+/// Get counters of the calling thread
+Counters& local_counters();
+
+/// Count move outcome of operator
+inline void count(Operator op, Outcome outcome) noexcept {
+    ++local_counters()
+          .moves[static_cast<size_t>(op)][static_cast<size_t>(outcome)];
+}
+
+/// Adds time of the scope and one call to counters on destruction
+class ScopedTimer {
+    uint64_t& m_calls;
+    uint64_t& m_nanoseconds;
+    std::chrono::steady_clock::time_point m_start;
+
+    ScopedTimer(Counters& counters, size_t op) noexcept
+        : ScopedTimer(counters.calls[op], counters.nanoseconds[op]) {}
+
+public:
+    ScopedTimer(uint64_t& calls, uint64_t& nanoseconds) noexcept
+        : m_calls(calls), m_nanoseconds(nanoseconds),
+          m_start(std::chrono::steady_clock::now()) {}
+
+    /// Timer of operator call
+    explicit ScopedTimer(Operator op) noexcept
+        : ScopedTimer(local_counters(), static_cast<size_t>(op)) {}
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    ~ScopedTimer() {
+        ++m_calls;
+        m_nanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             std::chrono::steady_clock::now() - m_start)
+                             .count();
+    }
+};
+}  // namespace perf
+}  // namespace vrp
+
+// counters are compiled out unless built with WITH_PERF_COUNTERS
+#if VRP_PERF_COUNTERS
+/// Count move outcome of operator
+#define PERF_COUNT(op, outcome)                                                \
+    ::vrp::perf::count(::vrp::perf::Operator::op, ::vrp::perf::Outcome::outcome)
+/// Measure time of the enclosing operator scope
+#define PERF_OPERATOR_TIMER(op)                                                \
+    const ::vrp::perf::ScopedTimer perf_operator_timer(                        \
+        ::vrp::perf::Operator::op)
+/// Measure time of the enclosing tabu search iteration scope
+#define PERF_ITERATION_TIMER()                                                 \
+    const ::vrp::perf::ScopedTimer perf_iteration_timer(                       \
+        ::vrp::perf::local_counters().tabu_iterations,                         \
+        ::vrp::perf::local_counters().tabu_nanoseconds)
+#else
+#define PERF_COUNT(op, outcome)
+#define PERF_OPERATOR_TIMER(op)
+#define PERF_ITERATION_TIMER()
+#endif
@@ -1,5 +1,7 @@
 #include "savings.h"
 #include "logging.h"
+#include "threading.h"
+#include "time_budget.h"
 
 #include <algorithm>
 #include <iostream>
@@ -11,9 +13,65 @@
 
 namespace vrp {
 namespace detail {
+namespace {
+// saving for i -> j edge
+struct S {
+    unsigned int i;
+    unsigned int j;
+    double save_ij;
+};
+
+/// compute savings list sorted in descending order of savings. if granular
+/// neighbourhoods are set up, only edges between candidate neighbours are
+/// considered, otherwise all edges between customers are
+std::vector<S> compute_savings(const Problem& prob) {
+    const unsigned int points = prob.customers.size();
+    auto saving = [&prob](unsigned int i, unsigned int j) -> S {
+        return {i, j, prob.costs(i, 0) + prob.costs(0, j) - prob.costs(i, j)};
+    };
+
+    std::vector<S> save;
+    if (prob.granular()) {
+        // both directions of i -> neighbour edge: neighbour can be added
+        // before or after i in a route
+        save.reserve(2 * prob.neighbours(1).size() * points);
+        for (unsigned int i = 1; i < points; ++i) {
+            for (size_t n : prob.neighbours(i)) {
+                const auto j = static_cast<unsigned int>(n);
+                save.emplace_back(saving(i, j));
+                // j -> i is added by j itself if i is its neighbour too
+                const auto& j_neighbours = prob.neighbours(j);
+                if (std::find(j_neighbours.cbegin(), j_neighbours.cend(), i) ==
+                    j_neighbours.cend()) {
+                    save.emplace_back(saving(j, i));
+                }
+            }
+        }
+    } else {
+        save.resize(points * points, {0, 0, 0});
+        for (unsigned int i = 0; i < points; ++i) {
+            for (unsigned int j = 0; j < points; ++j) {
+                save[i * points + j] = saving(i, j);
+            }
+        }
+    }
+
+    // sort and erase nonreq savings
+    std::sort(save.begin(), save.end(), [](const S& a, const S& b) {
+        return a.save_ij - b.save_ij > 0;
+    });
+
+    save.erase(std::remove_if(save.begin(), save.end(),
+                              [](const auto& o) {
+                                  return (o.i == o.j || o.i == 0 || o.j == 0);
+                              }),
+               save.end());
+    return save;
+}
+}  // namespace
 
 std::vector<Solution> savings(const Problem& prob, size_t count) {
-    std::vector<Solution> solutions;
+    std::vector<Solution> solutions(count);
 
     const auto cust_size = prob.customers.size() - 1;
     const auto points = cust_size + 1;  // + 1 for depo itself
@@ -23,7 +81,7 @@ std::vector<Solution> savings(const Problem& prob, size_t count) {
     const auto max_splits = prob.max_splits;
 
     std::random_device rd;
-    // a seed with the best result
+    // base seed: each solution is generated with own seed derived from it
     const auto seed = 1734553445u; //1330
     // const auto seed = 4241856268u; //1330
     // const auto seed = 1176554214u; //1585
@@ -32,10 +90,19 @@ std::vector<Solution> savings(const Problem& prob, size_t count) {
 
     // auto seed = rd();
 
-    std::mt19937 gen(seed);
-    std::uniform_int_distribution<> dis(1, cust_size);
+    // savings do not depend on generated solution: compute once, all
+    // iterations only read the list
+    const auto save = compute_savings(prob);
 
-    for (size_t it = 0; it < count; ++it) {
+    threading::parallel_for(count, [&](size_t it) {
+        // first solution is always built: there's a result to return
+        if (it != 0 && time_budget::expired()) {
+            return;
+        }
+        // derived seed makes the result independent of the order of execution
+        std::seed_seq seq{seed, static_cast<unsigned int>(it)};
+        std::mt19937 gen(seq);
+        std::uniform_int_distribution<> dis(1, cust_size);
 
         // split demands
         std::vector<TransportationQuantity> split_demand(points, {0, 0});
@@ -46,8 +113,20 @@ std::vector<Solution> savings(const Problem& prob, size_t count) {
         std::vector<size_t> splited(points, 1);
         splited[0] = 999;
 
-        // splited ratio
-        std::vector<double> splited_rat(points, 0.0);
+        // splited units of demand
+        std::vector<int> splited_units(points, 0);
+
+        // sets ratio of customer in split info to given units of its demand
+        const auto set_units = [&prob](SplitInfo& info, size_t cust,
+                                       int units) {
+            info.set(prob.customers[cust],
+                     SplitInfo::Ratio::of(prob.customers[cust], units));
+        };
+        // units of customer demand that are not splited yet
+        const auto remaining_units = [&prob, &splited_units](size_t cust) {
+            return SplitInfo::Ratio::total_units(prob.customers[cust]) -
+                   splited_units[cust];
+        };
 
         // vehicle id <-> customers ids
         std::vector<std::pair<size_t, std::vector<size_t>>> routes;
@@ -80,36 +159,6 @@ std::vector<Solution> savings(const Problem& prob, size_t count) {
                 vehicles_for_cust[i] = prob.customers[i].suitable_vehicles;
         }
 
-        // saving for i -> j edge
-        struct S {
-            unsigned int i;
-            unsigned int j;
-            double save_ij;
-        };
-
-        std::vector<S> save(points * points, {0, 0, 0});
-
-        // calculating matrix(vector) of savings
-        for (unsigned int i = 0; i < points; ++i) {
-            for (unsigned int j = 0; j < points; ++j) {
-                save[i * points + j] = {i, j,
-                                        prob.costs[i][0] + prob.costs[0][j] -
-                                            prob.costs[i][j]};
-            }
-        }
-
-        // sort and erase nonreq savings
-        std::sort(save.begin(), save.end(), [](const S& a, const S& b) {
-            return a.save_ij - b.save_ij > 0;
-        });
-
-        save.erase(std::remove_if(save.begin(), save.end(),
-                                  [](const auto& o) {
-                                      return (o.i == o.j || o.i == 0 ||
-                                              o.j == 0);
-                                  }),
-                   save.end());
-
         // times for customer
         struct Time {
             int start;
@@ -127,7 +176,7 @@ std::vector<Solution> savings(const Problem& prob, size_t count) {
                 prob.customers[i].hard_tw.first,
                 prob.customers[i].hard_tw.second,
                 std::max(prob.customers[i].hard_tw.first,
-                         prob.times[0][prob.customers[i].id]),
+                         prob.times(0, prob.customers[i].id)),
                 prob.customers[i].service_time};
         }
 
@@ -146,8 +195,11 @@ std::vector<Solution> savings(const Problem& prob, size_t count) {
 
         bool rand_split = 1;
         if (enable_splits) {
-            std::get<3>(current_route).split_info[rand_cust] = {1.0};
-            std::get<3>(current_route).split_info[0] = {1.0};
+            std::get<3>(current_route).set(
+                prob.customers[rand_cust],
+                SplitInfo::Ratio::whole_of(prob.customers[rand_cust]));
+            std::get<3>(current_route).set(prob.customers[0],
+                                           SplitInfo::Ratio());
             for (auto& a : std::get<0>(current_route))
                 if (prob.vehicles[a].capacity >= std::get<2>(current_route))
                     // can be served w/o split
@@ -172,9 +224,8 @@ std::vector<Solution> savings(const Problem& prob, size_t count) {
             std::get<2>(current_route) =
                 prob.vehicles[std::get<0>(current_route)[0]].capacity;
 
-            std::get<3>(current_route).split_info[rand_cust] = {
-                (double)std::get<2>(current_route).volume /
-                prob.customers[rand_cust].demand.volume};
+            set_units(std::get<3>(current_route), rand_cust,
+                      std::get<2>(current_route).volume);
 
             split_demand[rand_cust] -= std::get<2>(current_route);
 
@@ -184,8 +235,8 @@ std::vector<Solution> savings(const Problem& prob, size_t count) {
                 split_demand[rand_cust].weight = 0;
 
             ++splited[rand_cust];
-            splited_rat[rand_cust] +=
-                std::get<3>(current_route).split_info[rand_cust];
+            splited_units[rand_cust] +=
+                std::get<3>(current_route).at(rand_cust).units;
         }
 
         size_t route_sz = 1;
@@ -230,9 +281,10 @@ std::vector<Solution> savings(const Problem& prob, size_t count) {
                         }
 
                         if (enable_splits) {
-                            std::get<3>(current_route).split_info[0] = {1.0};
-                            std::get<3>(current_route).split_info[rand_cust] =
-                                1.0 - splited_rat[rand_cust];
+                            std::get<3>(current_route).set(
+                                prob.customers[0], SplitInfo::Ratio());
+                            set_units(std::get<3>(current_route), rand_cust,
+                                      remaining_units(rand_cust));
                         }
 
                         if (enable_splits &&
@@ -254,10 +306,9 @@ std::vector<Solution> savings(const Problem& prob, size_t count) {
                                     prob.vehicles[std::get<0>(current_route)[0]]
                                         .capacity;
 
-                                std::get<3>(current_route)
-                                    .split_info[rand_cust] = {
-                                    (double)std::get<2>(current_route).volume /
-                                    prob.customers[rand_cust].demand.volume};
+                                set_units(std::get<3>(current_route),
+                                          rand_cust,
+                                          std::get<2>(current_route).volume);
 
                                 split_demand[rand_cust] -=
                                     std::get<2>(current_route);
@@ -268,9 +319,10 @@ std::vector<Solution> savings(const Problem& prob, size_t count) {
                                     split_demand[rand_cust].weight = 0;
 
                                 ++splited[rand_cust];
-                                splited_rat[rand_cust] +=
+                                splited_units[rand_cust] +=
                                     std::get<3>(current_route)
-                                        .split_info[rand_cust];
+                                        .at(rand_cust)
+                                        .units;
                             }
                         }
                         break;
@@ -413,7 +465,7 @@ std::vector<Solution> savings(const Problem& prob, size_t count) {
 
                         int offset = times[best_save.i].current +
                                      times[best_save.i].service_time +
-                                     prob.times[best_save.i][best_save.j] -
+                                     prob.times(best_save.i, best_save.j) -
                                      times[best_save.j].current;
 
                         // do NOT remove the &
@@ -423,7 +475,7 @@ std::vector<Solution> savings(const Problem& prob, size_t count) {
                         auto curr = best_save.j;
                         int curr_time = times[best_save.i].current +
                                         times[best_save.i].service_time +
-                                        prob.times[best_save.i][best_save.j];
+                                        prob.times(best_save.i, best_save.j);
                         for (size_t s = 1; s < current_customers.size() - 1;
                              ++s) {
                             if (curr_time + times[curr].service_time >
@@ -435,7 +487,7 @@ std::vector<Solution> savings(const Problem& prob, size_t count) {
                             curr = current_customers[s + 1];
                             curr_time =
                                 std::max(curr_time + times[prev].service_time +
-                                             prob.times[prev][curr],
+                                             prob.times(prev, curr),
                                          times[curr].start);
                         }
 
@@ -446,9 +498,9 @@ std::vector<Solution> savings(const Problem& prob, size_t count) {
                                           [current_customers.size() - 2]]
                                     .service_time +
                                 offset +
-                                prob.times[current_customers
-                                               [current_customers.size() - 2]]
-                                          [0] >
+                                prob.times(current_customers
+                                               [current_customers.size() - 2],
+                                           0) >
                             times[0].finish) {
                             tw_violation = 1;
                         }
@@ -471,16 +523,15 @@ std::vector<Solution> savings(const Problem& prob, size_t count) {
                                     std::get<2>(current_route) -
                                     (tmp_cap - split_demand[best_save.i]);
 
-                                std::get<3>(current_route)
-                                    .split_info[best_save.i] = {
-                                    (double)splited_cap.volume /
-                                    prob.customers[best_save.i].demand.volume};
+                                set_units(std::get<3>(current_route),
+                                          best_save.i, splited_cap.volume);
 
-                                /*if
-                                   (std::get<3>(current_route).split_info[best_save.i]
-                                   < 0.0 ||
-                                    std::get<3>(current_route).split_info[best_save.i]
-                                   > 1.0) continue;*/
+                                /*if (std::get<3>(current_route)
+                                         .at(best_save.i)
+                                         .units < 0 ||
+                                    !std::get<3>(current_route)
+                                         .at(best_save.i)
+                                         .partial()) continue;*/
 
                                 split_demand[best_save.i] -= splited_cap;
 
@@ -490,17 +541,18 @@ std::vector<Solution> savings(const Problem& prob, size_t count) {
                                     split_demand[best_save.i].weight = 0;
 
                                 ++splited[best_save.i];
-                                splited_rat[best_save.i] +=
+                                splited_units[best_save.i] +=
                                     std::get<3>(current_route)
-                                        .split_info[best_save.i];
+                                        .at(best_save.i)
+                                        .units;
                             } else {
 
                                 ++served;
                                 dest[best_save.i] = 1;
                                 if (enable_splits)
-                                    std::get<3>(current_route)
-                                        .split_info[best_save.i] =
-                                        1.0 - splited_rat[best_save.i];
+                                    set_units(std::get<3>(current_route),
+                                              best_save.i,
+                                              remaining_units(best_save.i));
                                 std::get<2>(current_route) = tmp_cap;
                                 std::get<0>(current_route) = common_veh;
                             }
@@ -513,7 +565,7 @@ std::vector<Solution> savings(const Problem& prob, size_t count) {
                             int curr_time =
                                 times[best_save.i].current +
                                 times[best_save.i].service_time +
-                                prob.times[best_save.i][best_save.j];
+                                prob.times(best_save.i, best_save.j);
                             for (size_t c = 1; c < current_customers.size() - 1;
                                  ++c) {
                                 times[curr].current =
@@ -522,7 +574,7 @@ std::vector<Solution> savings(const Problem& prob, size_t count) {
                                 curr = current_customers[c + 1];
                                 curr_time = std::max(
                                     curr_time + times[prev].service_time +
-                                        prob.times[prev][curr],
+                                        prob.times(prev, curr),
                                     times[curr].start);
                             }
                         }
@@ -624,7 +676,7 @@ std::vector<Solution> savings(const Problem& prob, size_t count) {
 
                         int offset = times[best_save.i].current +
                                      times[best_save.i].service_time +
-                                     prob.times[best_save.i][best_save.j] -
+                                     prob.times(best_save.i, best_save.j) -
                                      times[best_save.j].current;
 
                         if (times[best_save.j].current + offset +
@@ -634,7 +686,7 @@ std::vector<Solution> savings(const Problem& prob, size_t count) {
                         }
 
                         if (times[best_save.j].current + offset +
-                                prob.times[best_save.j][0] +
+                                prob.times(best_save.j, 0) +
                                 times[best_save.j].service_time >
                             times[0].finish) {
                             tw_violation = 1;
@@ -658,15 +710,13 @@ std::vector<Solution> savings(const Problem& prob, size_t count) {
                                     std::get<2>(current_route) -
                                     (tmp_cap - split_demand[best_save.j]);
 
-                                std::get<3>(current_route)
-                                    .split_info[best_save.j] = {
-                                    (double)splited_cap.volume /
-                                    prob.customers[best_save.j].demand.volume};
+                                set_units(std::get<3>(current_route),
+                                          best_save.j, splited_cap.volume);
 
-                                if (std::get<3>(current_route)
-                                            .split_info[best_save.j] < 0.0 ||
-                                    std::get<3>(current_route)
-                                            .split_info[best_save.j] > 1.0)
+                                const auto ratio_j =
+                                    std::get<3>(current_route).at(best_save.j);
+                                if (ratio_j.units < 0 ||
+                                    ratio_j.units > ratio_j.total)
                                     continue;
 
                                 split_demand[best_save.j] -= splited_cap;
@@ -677,17 +727,18 @@ std::vector<Solution> savings(const Problem& prob, size_t count) {
                                     split_demand[best_save.j].weight = 0;
 
                                 ++splited[best_save.j];
-                                splited_rat[best_save.j] +=
+                                splited_units[best_save.j] +=
                                     std::get<3>(current_route)
-                                        .split_info[best_save.j];
+                                        .at(best_save.j)
+                                        .units;
                             } else {
 
                                 ++served;
                                 dest[best_save.j] = 1;
                                 if (enable_splits)
-                                    std::get<3>(current_route)
-                                        .split_info[best_save.j] =
-                                        1.0 - splited_rat[best_save.j];
+                                    set_units(std::get<3>(current_route),
+                                              best_save.j,
+                                              remaining_units(best_save.j));
                                 std::get<2>(current_route) = tmp_cap;
                                 std::get<0>(current_route) = common_veh;
                             }
@@ -744,7 +795,7 @@ std::vector<Solution> savings(const Problem& prob, size_t count) {
                         std::find(a.second.begin(), a.second.end(), cust) ==
                             a.second.end()) {
                         a.second.insert(a.second.end() - 1, cust);
-                        splits[ind].split_info[cust] = 1.0 - splited_rat[cust];
+                        set_units(splits[ind], cust, remaining_units(cust));
                         break;
                     }
                     ++ind;
@@ -775,8 +826,8 @@ std::vector<Solution> savings(const Problem& prob, size_t count) {
                             std::find(a.second.begin(), a.second.end(), cust) ==
                                 a.second.end()) {
                             a.second.insert(a.second.end() - 1, cust);
-                            splits[ind].split_info[cust] =
-                                1.0 - splited_rat[cust];
+                            set_units(splits[ind], cust,
+                                      remaining_units(cust));
                             break;
                         }
                         ++ind;
@@ -799,7 +850,7 @@ std::vector<Solution> savings(const Problem& prob, size_t count) {
                     bool us = 0;
                     int ind = 0;
                     size_t cst = 0;
-                    double inf = 0.0;
+                    SplitInfo::Ratio inf;
                     for (auto& b : routes) {
                         if (b.second.size() > 3) {
                             for (auto& cust : b.second) {
@@ -815,7 +866,8 @@ std::vector<Solution> savings(const Problem& prob, size_t count) {
                                                                cust),
                                                    b.second.end());
 
-                                    inf = splits[ind].split_info[cst];
+                                    if (splits[ind].has(cst))
+                                        inf = splits[ind].at(cst);
                                     splits[ind].split_info.erase(cst);
 
                                     us = 1;
@@ -835,22 +887,21 @@ std::vector<Solution> savings(const Problem& prob, size_t count) {
                     route_to_add.first = veh;
                     route_to_add.second = {0, cst, 0};
                     routes.push_back(route_to_add);
-                    splt.split_info[0] = {1.0};
-                    splt.split_info[cst] = {inf};
+                    splt.set(prob.customers[0], SplitInfo::Ratio());
+                    splt.set(prob.customers[cst], inf);
                     splits.push_back(splt);
                 }
             }
         }
 
         Solution sav_sol;
-        std::vector<std::pair<size_t, std::list<size_t>>> listed_routes(
+        std::vector<std::pair<size_t, Solution::RouteType>> listed_routes(
             routes.size());
         int ii = 0;
-        for (auto a : routes) {
+        for (const auto& a : routes) {
             listed_routes[ii].first = a.first;
-            for (auto b : a.second) {
-                listed_routes[ii].second.push_back(b);
-            }
+            listed_routes[ii].second =
+                Solution::RouteType(a.second.cbegin(), a.second.cend());
             ++ii;
         }
 
@@ -875,7 +926,8 @@ std::vector<Solution> savings(const Problem& prob, size_t count) {
         for (auto b : sav_sol.route_splits) {
 
             for (auto c : b.split_info) {
-                std::cout << c.first << " with " << c.second << " | ";
+                std::cout << c.first << " with " << c.second.ratio.value()
+                          << " | ";
             }
             std::cout << std::endl << std::endl;
         }
@@ -883,8 +935,8 @@ std::vector<Solution> savings(const Problem& prob, size_t count) {
                      "*********"
                   << std::endl;*/
 
-        solutions.push_back(sav_sol);
-    }
+        solutions[it] = std::move(sav_sol);
+    });
 
     return solutions;
 }  // namespace detail
@@ -1,4 +1,5 @@
 #include "subparsers.h"
+#include "threading.h"
 #include "utils.h"
 
 #include <map>
@@ -56,41 +57,53 @@ void throw_if_small_section(int expected, int section_length,
 namespace vrp {
 namespace detail {
 BaseParser::BaseParser(std::string name,
-                       const std::vector<std::string>& raw_data,
+                       const std::vector<TextRange>& raw_data,
                        const std::pair<int, int>& section, int min_section_size,
                        size_t row_length, char delimiter, int section_offset)
-    : m_delimiter(delimiter) {
-    /// perform basic input checks and split data into rows of string values
+    : m_name(name), m_row_length(row_length), m_delimiter(delimiter) {
+    /// perform basic input checks and keep data rows. rows are split into
+    /// values by derived parsers
     if (!name.empty()) {
-        throw_if_unexpected_table(name, raw_data[section.first]);
+        throw_if_unexpected_table(name, raw_data[section.first].str());
     }
     throw_if_small_section(min_section_size, section.second - section.first,
                            table(name));
     auto start = section.first + section_offset;
-    for (int i = start; i < section.second; ++i) {
-        auto values = split(raw_data[i], this->m_delimiter);
-        throw_if_small_row(row_length, values.size(), name, i - start);
-        this->m_raw_values.push_back(std::move(values));
-    }
+    this->m_rows.assign(raw_data.cbegin() + start,
+                        raw_data.cbegin() + section.second);
+}
+
+void BaseParser::check_row_length(size_t row, size_t actual) const {
+    throw_if_small_row(this->m_row_length, actual, this->m_name,
+                       static_cast<int>(row));
+}
+
+std::vector<TextRange> BaseParser::values(size_t row) const {
+    auto values = split(this->m_rows[row], this->m_delimiter);
+    check_row_length(row, values.size());
+    return values;
 }
 
 constexpr char CustomerTableParser::table_name[];
 CustomerTableParser::CustomerTableParser(
-    const std::vector<std::string>& raw_data,
+    const std::vector<TextRange>& raw_data,
     const std::pair<int, int>& table_section, size_t row_length, char delimiter)
     : BaseParser(CustomerTableParser::table_name, raw_data, table_section, 3,
                  row_length, delimiter, 2) {
-    for (const auto& row : this->m_raw_values) {
-        auto vehicles = std::vector<std::string>(row.cbegin() + 8, row.cend());
+    this->customers.reserve(this->m_rows.size());
+    for (size_t i = 0, size = this->m_rows.size(); i < size; ++i) {
+        const auto row = this->values(i);
         std::vector<int> suitable = {};
-        suitable.reserve(vehicles.size());
-        for (const auto& v : vehicles) suitable.push_back(std::stoi(v));
+        const auto first_vehicle = row.cbegin() + std::min(row.size(), size_t(8));
+        suitable.reserve(row.cend() - first_vehicle);
+        for (auto v = first_vehicle; v != row.cend(); ++v) {
+            suitable.push_back(to_int(*v));
+        }
         this->customers.push_back(
-            {std::stoi(row[0]),
-             TransportationQuantity{std::stoi(row[1]), std::stoi(row[2])},
-             std::make_pair(std::stoi(row[3]), std::stoi(row[4])),
-             std::make_pair(std::stoi(row[5]), std::stoi(row[6])),
-             std::stoi(row[7]), suitable});
+            {to_int(row[0]), TransportationQuantity{to_int(row[1]), to_int(row[2])},
+             std::make_pair(to_int(row[3]), to_int(row[4])),
+             std::make_pair(to_int(row[5]), to_int(row[6])), to_int(row[7]),
+             suitable});
     }
 }
 
@@ -99,62 +112,67 @@ std::vector<Customer> CustomerTableParser::get() const {
 }
 
 constexpr char VehicleTableParser::table_name[];
-VehicleTableParser::VehicleTableParser(const std::vector<std::string>& raw_data,
+VehicleTableParser::VehicleTableParser(const std::vector<TextRange>& raw_data,
                                        const std::pair<int, int>& table_section,
                                        size_t row_length, char delimiter)
     : BaseParser(VehicleTableParser::table_name, raw_data, table_section, 3,
                  row_length, delimiter, 2) {
-    for (const auto& row : this->m_raw_values) {
+    this->vehicles.reserve(this->m_rows.size());
+    for (size_t i = 0, size = this->m_rows.size(); i < size; ++i) {
+        const auto row = this->values(i);
         this->vehicles.push_back(
-            {std::stoi(row[0]),
-             TransportationQuantity{std::stoi(row[1]), std::stoi(row[2])},
-             std::stod(row[3]), std::stod(row[4])});
+            {to_int(row[0]), TransportationQuantity{to_int(row[1]), to_int(row[2])},
+             to_double(row[3]), to_double(row[4])});
     }
 }
 
 std::vector<Vehicle> VehicleTableParser::get() const { return this->vehicles; }
 
 constexpr char CostTableParser::table_name[];
-CostTableParser::CostTableParser(const std::vector<std::string>& raw_data,
+CostTableParser::CostTableParser(const std::vector<TextRange>& raw_data,
                                  const std::pair<int, int>& table_section,
                                  size_t row_length, char delimiter)
     : BaseParser(CostTableParser::table_name, raw_data, table_section, 2,
                  row_length, delimiter, 1) {
-    for (const auto& row : this->m_raw_values) {
-        this->costs.push_back({});
-        std::transform(row.cbegin(), row.cend(),
-                       std::back_inserter(this->costs.back()),
-                       [](const std::string& s) { return std::stod(s); });
-    }
+    const auto rows = this->m_rows.size();
+    this->costs = CostMatrix(rows, row_length);
+    // rows are independent: parse them in parallel
+    threading::parallel_for(rows, [this](size_t i) {
+        this->parse_row(i, this->costs[i].begin(), [](TextRange s) {
+            return static_cast<CostType>(to_double(s));
+        });
+    });
 }
 
-std::vector<std::vector<double>> CostTableParser::get() const {
+CostMatrix CostTableParser::get() const {
     return this->costs;
 }
 
 constexpr char TimeTableParser::table_name[];
-TimeTableParser::TimeTableParser(const std::vector<std::string>& raw_data,
+TimeTableParser::TimeTableParser(const std::vector<TextRange>& raw_data,
                                  const std::pair<int, int>& table_section,
                                  size_t row_length, char delimiter)
     : BaseParser(TimeTableParser::table_name, raw_data, table_section, 2,
                  row_length, delimiter, 1) {
-    for (const auto& row : this->m_raw_values) {
-        this->times.push_back({});
-        std::transform(row.cbegin(), row.cend(),
-                       std::back_inserter(this->times.back()),
-                       [](const std::string& s) { return std::stoi(s); });
-    }
+    const auto rows = this->m_rows.size();
+    this->times = TimeMatrix(rows, row_length);
+    // rows are independent: parse them in parallel
+    threading::parallel_for(rows, [this](size_t i) {
+        this->parse_row(i, this->times[i].begin(), [](TextRange s) {
+            return static_cast<TimeType>(to_int(s));
+        });
+    });
 }
 
-std::vector<std::vector<int>> TimeTableParser::get() const {
+TimeMatrix TimeTableParser::get() const {
     return this->times;
 }
 
-IntValueParser::IntValueParser(const std::vector<std::string>& raw_data,
+IntValueParser::IntValueParser(const std::vector<TextRange>& raw_data,
                                const std::pair<int, int>& value_section,
                                size_t row_length, char delimiter)
     : BaseParser("", raw_data, value_section, 2, row_length, delimiter, 1) {
-    this->value = std::stoi(this->m_raw_values[0][0]);
+    this->value = to_int(this->values(0)[0]);
 }
 
 int IntValueParser::get() const { return value; }
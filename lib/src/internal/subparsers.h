@@ -1,6 +1,8 @@
 #pragma once
 
 #include "customer.h"
+#include "matrix.h"
+#include "utils.h"
 #include "vehicle.h"
 
 #include <cstdint>
@@ -14,11 +16,30 @@ namespace detail {
 /// Base class with common parsing checks
 class BaseParser {
 protected:
-    std::vector<std::vector<std::string>> m_raw_values = {};
+    std::vector<TextRange> m_rows = {};  ///< data rows of the section
+    const std::string m_name = "";
+    const size_t m_row_length = 0;
     const char m_delimiter = ';';
 
+    /// Throws if row has less than row length values
+    void check_row_length(size_t row, size_t actual) const;
+
+    /// Split row into values
+    std::vector<TextRange> values(size_t row) const;
+
+    /// Parse first row length values of the row into matrix row
+    template<typename T, typename Converter>
+    void parse_row(size_t row, T* dst, Converter convert) const {
+        TextRange src = m_rows[row], value = {};
+        size_t count = 0;
+        while (count < m_row_length && next_field(src, m_delimiter, value)) {
+            dst[count++] = convert(value);
+        }
+        check_row_length(row, count);
+    }
+
 public:
-    BaseParser(std::string name, const std::vector<std::string>& raw_data,
+    BaseParser(std::string name, const std::vector<TextRange>& raw_data,
                const std::pair<int, int>& section, int min_section_size,
                size_t row_length, char delimiter = ';', int section_offset = 0);
 };
@@ -38,7 +59,7 @@ class CustomerTableParser : public BaseParser {
 public:
     static constexpr char table_name[] = "customer";
 
-    CustomerTableParser(const std::vector<std::string>& raw_data,
+    CustomerTableParser(const std::vector<TextRange>& raw_data,
                         const std::pair<int, int>& table_section,
                         size_t row_length, char delimiter = ';');
 
@@ -59,7 +80,7 @@ class VehicleTableParser : public BaseParser {
 public:
     static constexpr char table_name[] = "vehicle";
 
-    VehicleTableParser(const std::vector<std::string>& raw_data,
+    VehicleTableParser(const std::vector<TextRange>& raw_data,
                        const std::pair<int, int>& table_section,
                        size_t row_length, char delimiter = ';');
 
@@ -74,16 +95,16 @@ public:
  *  > matrix NxN where N is the number of customers
  */
 class CostTableParser : public BaseParser {
-    std::vector<std::vector<double>> costs = {};
+    CostMatrix costs = {};
 
 public:
     static constexpr char table_name[] = "cost";
 
-    CostTableParser(const std::vector<std::string>& raw_data,
+    CostTableParser(const std::vector<TextRange>& raw_data,
                     const std::pair<int, int>& table_section, size_t row_length,
                     char delimiter = ';');
 
-    std::vector<std::vector<double>> get() const;
+    CostMatrix get() const;
 };
 
 /// Time table parser
@@ -94,16 +115,16 @@ public:
  *  > matrix NxN where N is the number of customers
  */
 class TimeTableParser : public BaseParser {
-    std::vector<std::vector<int>> times = {};
+    TimeMatrix times = {};
 
 public:
     static constexpr char table_name[] = "time";
 
-    TimeTableParser(const std::vector<std::string>& raw_data,
+    TimeTableParser(const std::vector<TextRange>& raw_data,
                     const std::pair<int, int>& table_section, size_t row_length,
                     char delimiter = ';');
 
-    std::vector<std::vector<int>> get() const;
+    TimeMatrix get() const;
 };
 
 /// 32-bit integer parser
@@ -117,7 +138,7 @@ class IntValueParser : public BaseParser {
     int value = std::numeric_limits<int>::max();
 
 public:
-    IntValueParser(const std::vector<std::string>& raw_data,
+    IntValueParser(const std::vector<TextRange>& raw_data,
                    const std::pair<int, int>& value_section, size_t row_length,
                    char delimiter = ';');
 
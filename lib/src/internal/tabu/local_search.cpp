@@ -3,8 +3,10 @@
 #include "objective.h"
 
 #include "logging.h"
+#include "src/internal/counters.h"
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <cmath>
 #include <list>
@@ -38,30 +40,24 @@ inline bool site_dependent(const Problem& prob, size_t vehicle,
     return allowed[vehicle];
 }
 
-// site dependency check for a vector
-inline bool site_dependent(const Problem& prob, size_t vehicle,
-                           const std::vector<size_t>& customers) {
-    for (auto c : customers) {
-        if (!site_dependent(prob, vehicle, c)) {
+// site dependency check for a range
+template<typename ListIt>
+inline bool site_dependent(const Problem& prob, size_t vehicle, ListIt first,
+                           ListIt last) {
+    for (; first != last; ++first) {
+        if (!site_dependent(prob, vehicle, *first)) {
             return false;
         }
     }
     return true;
 }
 
-inline Solution::CustomerIndex at(const Solution::RouteType& route, size_t i) {
-    if (i >= route.size()) {
-        throw std::out_of_range("i >= route size");
-    }
-    return *std::next(route.cbegin(), i);
-}
-
 inline Solution::RouteType::iterator atit(Solution::RouteType& route,
                                           size_t i) {
     if (i >= route.size()) {
         throw std::out_of_range("i >= route size");
     }
-    return std::next(route.begin(), i);
+    return route.begin() + i;
 }
 
 inline Solution::RouteType::const_iterator
@@ -69,64 +65,239 @@ atit(const Solution::RouteType& route, size_t i) {
     if (i > route.size()) {
         throw std::out_of_range("i >= route size");
     }
-    return std::next(route.cbegin(), i);
+    return route.cbegin() + i;
 }
 
-template<typename ListIt>
-inline double violated_time(const Problem& prob, const SplitInfo& info,
+/// split info of a route after entries were transferred to it from another
+/// route: entries missing in dst are looked up in src. allows to evaluate a
+/// move without transferring split entries
+struct TransferredSplitInfo {
+    const SplitInfo& dst;
+    const SplitInfo& src;
+    inline const SplitInfo& of(const Customer& c) const {
+        return dst.has(c.id) ? dst : src;
+    }
+    inline TransportationQuantity demand(const Customer& c) const {
+        return of(c).demand(c);
+    }
+    inline int service_time(const Customer& c) const {
+        return of(c).service_time(c);
+    }
+};
+
+/// split info with a single split replaced
+struct ReplacedSplitInfo {
+    const SplitInfo& info;
+    size_t key;
+    SplitInfo::Split split;
+    inline TransportationQuantity demand(const Customer& c) const {
+        return size_t(c.id) == key ? split.demand : info.demand(c);
+    }
+    inline int service_time(const Customer& c) const {
+        return size_t(c.id) == key ? split.service_time : info.service_time(c);
+    }
+};
+
+template<typename Info, typename ListIt>
+inline double violated_time(const Problem& prob, const Info& info,
                             double penalty, ListIt first, ListIt last) {
+    if (penalty == 0.0) {
+        return 0.0;
+    }
     return penalty *
            (constraints::total_violated_time(prob, info, first, last));
 }
 
-/// calculate route distance. this is an oversimplified "objective function
-/// part"
+/// violated time for a range which time window segment is known: the scan is
+/// skipped when the segment proves that time windows are satisfied
+template<typename Info, typename ListIt>
+inline double violated_time(const Problem& prob, const Info& info,
+                            double penalty, const TimeWindowSegment& segment,
+                            ListIt first, ListIt last) {
+    if (segment.satisfies_time_windows()) {
+        return 0.0;
+    }
+    return violated_time(prob, info, penalty, first, last);
+}
+
+/// time window segment of a route with customer inserted before position i
+template<typename Info>
+inline TimeWindowSegment tw_with_inserted(const Problem& prob,
+                                          const Info& info,
+                                          const RouteTimeWindows& segments,
+                                          const Solution::RouteType& route,
+                                          size_t i, size_t customer) {
+    const auto head = constraints::tw_concatenate(
+        prob, segments.forward[i - 1], route[i - 1], customer,
+        constraints::tw_segment(prob, info, customer));
+    return constraints::tw_concatenate(prob, head, customer, route[i],
+                                       segments.backward[i]);
+}
+
+/// time window segment of a route with value at position i erased
+inline TimeWindowSegment tw_with_erased(const Problem& prob,
+                                        const RouteTimeWindows& segments,
+                                        const Solution::RouteType& route,
+                                        size_t i) {
+    return constraints::tw_concatenate(prob, segments.forward[i - 1],
+                                       route[i - 1], route[i + 1],
+                                       segments.backward[i + 1]);
+}
+
+/// time window segment of a route with positions [first, last) replaced by
+/// non-empty range [nodes_first, nodes_last)
+template<typename Info, typename ListIt>
+inline TimeWindowSegment
+tw_with_replaced(const Problem& prob, const Info& info,
+                 const RouteTimeWindows& segments,
+                 const Solution::RouteType& route, size_t first, size_t last,
+                 ListIt nodes_first, ListIt nodes_last) {
+    const auto head = constraints::tw_concatenate(
+        prob, segments.forward[first - 1], route[first - 1], *nodes_first,
+        constraints::tw_segment(prob, info, nodes_first, nodes_last));
+    return constraints::tw_concatenate(prob, head, *std::prev(nodes_last),
+                                       route[last], segments.backward[last]);
+}
+
+/// time window segment of a route which tail after position i is replaced by
+/// the tail of other route starting at position j
+inline TimeWindowSegment tw_with_tail(const Problem& prob,
+                                      const RouteTimeWindows& segments,
+                                      const Solution::RouteType& route,
+                                      size_t i,
+                                      const RouteTimeWindows& other_segments,
+                                      const Solution::RouteType& other_route,
+                                      size_t j) {
+    return constraints::tw_concatenate(prob, segments.forward[i], route[i],
+                                       other_route[j],
+                                       other_segments.backward[j]);
+}
+
+/// get neighbours to explore for customer: candidate list if granular
+/// neighbourhoods are set up, all customers otherwise
+inline const std::vector<size_t>& neighbours(const Problem& prob,
+                                             size_t customer,
+                                             const std::vector<size_t>& all) {
+    return prob.granular() ? prob.neighbours(customer) : all;
+}
+
+/// get arc costs of the route's vehicle: combined arc costs of the vehicle if
+/// set up, plain costs otherwise
+inline const CostMatrix& route_costs(const Problem& prob, const Solution& sln,
+                                     size_t route) {
+    return prob.arc_costs(sln.routes[route].first);
+}
+
+#if VRP_PERF_COUNTERS
+/// count outcome of evaluated move. infeasible moves are counted as capacity
+/// or time windows rejections, other impossible moves as tabu rejections
+inline void count_move(perf::Operator op, bool impossible_move,
+                       const MoveCost& cost) {
+    perf::count(op, perf::Outcome::Evaluated);
+    if (!cost.satisfies_capacity) {
+        perf::count(op, perf::Outcome::RejectedCapacity);
+    } else if (!cost.satisfies_time_windows) {
+        perf::count(op, perf::Outcome::RejectedTimeWindows);
+    } else if (impossible_move) {
+        perf::count(op, perf::Outcome::RejectedTabu);
+    } else if (cost.after < cost.before) {
+        perf::count(op, perf::Outcome::Accepted);
+    } else {
+        perf::count(op, perf::Outcome::NotImproving);
+    }
+}
+/// count outcome of evaluated move of operator
+#define COUNT_MOVE(op, impossible_move, cost)                                  \
+    count_move(perf::Operator::op, impossible_move, cost)
+#else
+#define COUNT_MOVE(op, impossible_move, cost)
+#endif
+
+/// calculate route distance given violated time penalty of the range
 template<typename ListIt>
-inline double distance_on_route(const Problem& prob, const SplitInfo& info,
-                                double penalty, ListIt first, ListIt last) {
+inline double distance_on_route(const CostMatrix& costs, double violation,
+                                ListIt first, ListIt last) {
     if (first == last) {
         throw std::runtime_error("empty range provided");
     }
 
-    double distance = violated_time(prob, info, penalty, first, last);
+    double distance = violation;
 
     auto next_first = std::next(first);
     for (; next_first != last; ++first, ++next_first) {
-        distance += prob.costs[*first][*next_first];
+        distance += costs(*first, *next_first);
     }
 
     return distance;
 }
 
-inline double distance_on_route(const Problem& prob, const SplitInfo& info,
-                                double penalty,
+/// calculate distance of route part that consists of node followed by range
+/// [first, last), given violated time penalty of the part
+template<typename ListIt>
+inline double distance_on_joined_route(const CostMatrix& costs,
+                                       double violation, size_t node,
+                                       ListIt first, ListIt last) {
+    if (first == last) {
+        throw std::runtime_error("empty range provided");
+    }
+    double distance = violation;
+    distance += costs(node, *first);
+    return distance_on_route(costs, distance, first, last);
+}
+
+/// calculate route distance. this is an oversimplified "objective function
+/// part"
+template<typename Info, typename ListIt>
+inline double distance_on_route(const Problem& prob, const CostMatrix& costs,
+                                const Info& info, double penalty, ListIt first,
+                                ListIt last) {
+    if (first == last) {
+        throw std::runtime_error("empty range provided");
+    }
+
+    return distance_on_route(
+        costs, violated_time(prob, info, penalty, first, last), first, last);
+}
+
+/// calculate route distance for positions [first_i, last_i). operators that
+/// insert or erase nodes use positions as route iterators get invalidated
+inline double distance_on_route(const Problem& prob, const CostMatrix& costs,
+                                const SplitInfo& info, double penalty,
                                 const Solution::RouteType& route,
                                 size_t first_i, size_t last_i) {
-    // FIXME: always use iterator version, remove this one
     if (first_i > last_i || first_i > route.size()) {
         throw std::out_of_range("invalid indices");
     }
-    return distance_on_route(prob, info, penalty, atit(route, first_i),
+    return distance_on_route(prob, costs, info, penalty, atit(route, first_i),
                              atit(route, last_i));
 }
 
+/// calculate distance of nodes given in order
+template<typename Info, size_t N>
+inline double distance_on_nodes(const Problem& prob, const CostMatrix& costs,
+                                const Info& info, double penalty,
+                                const std::array<size_t, N>& nodes) {
+    return distance_on_route(prob, costs, info, penalty, nodes.cbegin(),
+                             nodes.cend());
+}
+
 // calculate distance for a pair of "independent" iterators: dist(i-1, i+1) +
 // dist(k-1, k+1), where: (i-1)->(i)->(i+1) && (k-1)->(k)->(k+1)
 template<typename ListIt>
-inline double paired_distance_on_route(const Problem& prob,
-                                       const SplitInfo& info1,
-                                       const SplitInfo& info2, double penalty,
-                                       ListIt i, ListIt k) {
-    return distance_on_route(prob, info1, penalty, std::prev(i),
+inline double paired_distance_on_route(
+    const Problem& prob, const CostMatrix& costs1, const CostMatrix& costs2,
+    const SplitInfo& info1, const SplitInfo& info2, double penalty, ListIt i,
+    ListIt k) {
+    return distance_on_route(prob, costs1, info1, penalty, std::prev(i),
                              std::next(i, 2)) +
-           distance_on_route(prob, info2, penalty, std::prev(k),
+           distance_on_route(prob, costs2, info2, penalty, std::prev(k),
                              std::next(k, 2));
 }
 
 /// calculate total demand for given range
-template<typename ListIt>
+template<typename Info, typename ListIt>
 inline TransportationQuantity total_demand(const Problem& prob,
-                                           const SplitInfo& info, ListIt first,
+                                           const Info& info, ListIt first,
                                            ListIt last) {
     if (first == last) {
         throw std::runtime_error("empty range provided");
@@ -138,12 +309,18 @@ inline TransportationQuantity total_demand(const Problem& prob,
     for (; first != last; ++first) {
         const auto& c = customers[*first];
         assert(static_cast<size_t>(c.id) == *first);
-        demand += (c.demand * info.at(c.id));
+        demand += info.demand(c);
     }
 
     return demand;
 }
 
+/// check whether info has any of customers in range [first, last)
+template<typename ListIt>
+inline bool has_any(const SplitInfo& info, ListIt first, ListIt last) {
+    return std::any_of(first, last, [&info](size_t i) { return info.has(i); });
+}
+
 inline bool is_loop(const Solution::RouteType& route) {
     if (route.size() > 2) {
         return false;
@@ -175,8 +352,17 @@ void delete_loops_after_relocate(
                   std::make_move_iterator(route_splits_part.end()),
                   std::next(sln.route_splits.begin(), loop_id));
 
-        // erase loop from routes
+        // erase loop from routes. loop has no customers: only owners of the
+        // routes after the loop change
         sln.routes.erase(loop_index);
+        for (size_t ri = loop_id, size = sln.routes.size(); ri < size; ++ri) {
+            for (size_t customer : sln.routes[ri].second) {
+                if (customer == 0) {
+                    continue;
+                }
+                sln.customer_owners.rename(customer, ri + 1, ri);
+            }
+        }
         loop_indices.pop();
     }
 }
@@ -200,58 +386,28 @@ void delete_loops_after_relocate(Solution& sln, TabuLists& lists) {
         }
     }
 
-    auto delete_loops_in_tabu_list = [&loop_indices](const Solution& sln,
-                                                     auto& relocate_list) {
-        auto loop_indices_copy = loop_indices;
-        while (!loop_indices_copy.empty()) {
-            auto loop = loop_indices_copy.top();
-
-            size_t ri = std::distance(sln.routes.cbegin(), loop);
-            std::decay_t<decltype(relocate_list)> fixed_relocate_list = {};
-            while (!relocate_list.empty()) {
-                auto entry = *relocate_list.begin();
-                relocate_list.erase(relocate_list.begin());
-                if (entry.second == ri) {
-                    continue;
-                }
-                for (size_t i = ri + 1, size = sln.routes.size(); i < size;
-                     ++i) {
-                    if (entry.second == i) {
-                        entry.second--;
-                        break;
-                    }
-                }
-                fixed_relocate_list.emplace(entry);
-            }
-            relocate_list = std::move(fixed_relocate_list);
-            loop_indices_copy.pop();
-        }
-    };
-
-    delete_loops_in_tabu_list(sln, lists.relocate.all());
-    delete_loops_in_tabu_list(sln, lists.relocate_new_route.all());
-    delete_loops_in_tabu_list(sln, lists.relocate_split.all());
+    // loops are deleted starting from the last one, so indices of the
+    // remaining loops stay valid
+    auto loop_indices_copy = loop_indices;
+    while (!loop_indices_copy.empty()) {
+        const size_t ri = std::distance(sln.routes.cbegin(),
+                                        loop_indices_copy.top());
+        const size_t size = sln.routes.size();
+        lists.relocate.erase_column(ri, size);
+        lists.relocate_new_route.erase_column(ri, size);
+        lists.relocate_split.erase_column(ri, size);
+        loop_indices_copy.pop();
+    }
 
     delete_loops_after_relocate(sln, std::move(loop_indices));
 }
 
-template<typename ListIt>
-inline void cross_routes(Solution::RouteType& lhs, ListIt lhs_first,
-                         Solution::RouteType& rhs, ListIt rhs_first) {
-    auto tmp = rhs;
-    auto tmp_first =
-        std::next(tmp.begin(), std::distance(rhs.begin(), rhs_first));
-
-    rhs.erase(rhs_first, rhs.end());
-
-    rhs.splice(rhs.end(), lhs, lhs_first, lhs.end());
-    lhs.splice(lhs.end(), tmp, tmp_first, tmp.end());
-}
-
 inline Solution::RouteType add_depots(const Solution::RouteType& route) {
     static constexpr const Solution::CustomerIndex depot = 0;
-    auto copy = route;
-    copy.emplace_front(depot);
+    Solution::RouteType copy;
+    copy.reserve(route.size() + 2);
+    copy.emplace_back(depot);
+    copy.insert(copy.cend(), route.cbegin(), route.cend());
     copy.emplace_back(depot);
     return copy;
 }
@@ -280,14 +436,13 @@ find_closest(const Problem& prob, Solution& sln, size_t src_id, size_t dst_id,
         if (i == src_ignored_id) {
             continue;
         }
-        const auto& r = src_info.at(i);
         // skip split customers in src route
-        if (r > 0.0 && r < 1.0) {
+        if (src_info.at(i).partial()) {
             continue;
         }
         auto min = std::min_element(
             dst_first, dst_end, [&prob, i](size_t a, size_t b) {
-                return prob.costs[i][a] < prob.costs[i][b];
+                return prob.costs(i, a) < prob.costs(i, b);
             });
         closest_pairs.emplace_back(src_first, min);
     }
@@ -299,8 +454,8 @@ find_closest(const Problem& prob, Solution& sln, size_t src_id, size_t dst_id,
     // find closest pair of (src, dst) nodes in existing
     return *std::min_element(closest_pairs.cbegin(), closest_pairs.cend(),
                              [&prob](const IterPair& a, const IterPair& b) {
-                                 return prob.costs[*a.first][*a.second] <
-                                        prob.costs[*b.first][*b.second];
+                                 return prob.costs(*a.first, *a.second) <
+                                        prob.costs(*b.first, *b.second);
                              });
 }
 
@@ -326,9 +481,8 @@ find_closest(const Problem& prob, Solution& sln, size_t src_id,
         if (i == src_ignored_id) {
             continue;
         }
-        const auto& r = src_info.at(i);
         // skip split customers in src route
-        if (r > 0.0 && r < 1.0) {
+        if (src_info.at(i).partial()) {
             continue;
         }
         closest_pairs.emplace_back(src_first, node_it);
@@ -341,8 +495,8 @@ find_closest(const Problem& prob, Solution& sln, size_t src_id,
     // find closest pair of (src, dst) nodes in existing
     return *std::min_element(closest_pairs.cbegin(), closest_pairs.cend(),
                              [&prob](const IterPair& a, const IterPair& b) {
-                                 return prob.costs[*a.first][*a.second] <
-                                        prob.costs[*b.first][*b.second];
+                                 return prob.costs(*a.first, *a.second) <
+                                        prob.costs(*b.first, *b.second);
                              });
 }
 
@@ -375,9 +529,7 @@ LocalSearchMethods::LocalSearchMethods(const Problem& prob) noexcept
     assert(m_methods.size() == m_best_values.size());
 
     if (!prob.enable_splits()) {
-        for (size_t c = 0, size = prob.n_customers(); c < size; ++c) {
-            m_default_split_info.split_info[c] = 1.0;
-        }
+        m_default_split_info = SplitInfo::all_customers();
     }
 }
 
@@ -416,11 +568,481 @@ inline void validate_indices(
     assert(c_id < routes[r_id].second.size());
 }
 
+MoveCost LocalSearchMethods::evaluate(const Solution& sln,
+                                      const RelocateMove& move) const {
+    const auto& route_in = sln.routes[move.r_in].second;
+    const auto& route_out = sln.routes[move.r_out].second;
+    const auto& split_in = sln.route_splits[move.r_in];
+    const auto& split_out = sln.route_splits[move.r_out];
+    const TransferredSplitInfo split_out_after = {split_out, split_in};
+    const auto& costs_in = route_costs(m_prob, sln, move.r_in);
+    const auto& costs_out = route_costs(m_prob, sln, move.r_out);
+    const auto customer = move.customer;
+    const auto c_index = move.c_index, n_index = move.n_index;
+
+    MoveCost cost;
+    // (i -> customer -> j) and (k -> neighbour -> l)
+    cost.before = distance_on_route(m_prob, costs_in, split_in, m_tw_penalty,
+                                    route_in, c_index - 1, c_index + 2) +
+                  distance_on_route(m_prob, costs_out, split_out, m_tw_penalty,
+                                    route_out, n_index - 1, n_index + 2);
+
+    // (i -> j) and (k -> [customer] -> neighbour -> [customer] -> l)
+    const std::array<size_t, 2> in_after = {route_in[c_index - 1],
+                                            route_in[c_index + 1]};
+    std::array<size_t, 4> out_after = {route_out[n_index - 1], customer,
+                                       route_out[n_index],
+                                       route_out[n_index + 1]};
+    if (move.insert_index != n_index) {
+        std::swap(out_after[1], out_after[2]);
+    }
+    cost.after = distance_on_nodes(m_prob, costs_in, split_in, m_tw_penalty,
+                                   in_after) +
+                 distance_on_nodes(m_prob, costs_out, split_out_after,
+                                   m_tw_penalty, out_after);
+
+    const auto out_demand_after =
+        total_demand(m_prob, split_out, route_out.cbegin(), route_out.cend()) +
+        split_in.demand(m_prob.customers[customer]);
+    const auto out_capacity =
+        m_prob.vehicles[sln.routes[move.r_out].first].capacity;
+    cost.satisfies_capacity = !(out_demand_after > out_capacity);
+
+    cost.satisfies_time_windows =
+        m_can_violate_tw ||
+        (tw_with_erased(m_prob, sln.tw_segments[move.r_in], route_in, c_index)
+             .satisfies_time_windows() &&
+         tw_with_inserted(m_prob, split_out_after, sln.tw_segments[move.r_out],
+                          route_out, move.insert_index, customer)
+             .satisfies_time_windows());
+    return cost;
+}
+
+MoveCost LocalSearchMethods::evaluate(const Solution& sln,
+                                      const NewRouteMove& move) const {
+    static constexpr const size_t depot = 0;
+    const auto& route_in = sln.routes[move.r_in].second;
+    const auto& split_in = sln.route_splits[move.r_in];
+    const auto& costs_in = route_costs(m_prob, sln, move.r_in);
+    const auto c_index = move.c_index;
+
+    MoveCost cost;
+    cost.before = distance_on_route(m_prob, costs_in, split_in, m_tw_penalty,
+                                    route_in, c_index - 1, c_index + 2);
+
+    const std::array<size_t, 2> in_after = {route_in[c_index - 1],
+                                            route_in[c_index + 1]};
+    const std::array<size_t, 3> new_route = {depot, move.customer, depot};
+    cost.after =
+        distance_on_nodes(m_prob, costs_in, split_in, m_tw_penalty, in_after) +
+        distance_on_nodes(m_prob, m_prob.arc_costs(move.vehicle),
+                          TransferredSplitInfo{m_default_split_info, split_in},
+                          m_tw_penalty, new_route);
+    return cost;
+}
+
+MoveCost LocalSearchMethods::evaluate(const Solution& sln,
+                                      const ExchangeMove& move) const {
+    const auto& route1 = sln.routes[move.r1].second;
+    const auto& route2 = sln.routes[move.r2].second;
+    const auto& split1 = sln.route_splits[move.r1];
+    const auto& split2 = sln.route_splits[move.r2];
+    const TransferredSplitInfo split1_after = {split1, split2};
+    const TransferredSplitInfo split2_after = {split2, split1};
+    const auto& costs1 = route_costs(m_prob, sln, move.r1);
+    const auto& costs2 = route_costs(m_prob, sln, move.r2);
+    const auto c_index = move.c_index, n_index = move.n_index;
+    const std::array<size_t, 1> customer = {route1[c_index]},
+                                neighbour = {route2[n_index]};
+
+    MoveCost cost;
+    cost.before = paired_distance_on_route(
+        m_prob, costs1, costs2, split1, split2, m_tw_penalty,
+        atit(route1, c_index), atit(route2, n_index));
+
+    const std::array<size_t, 3> route1_after = {
+        route1[c_index - 1], neighbour[0], route1[c_index + 1]};
+    const std::array<size_t, 3> route2_after = {
+        route2[n_index - 1], customer[0], route2[n_index + 1]};
+    cost.after = distance_on_nodes(m_prob, costs1, split1_after, m_tw_penalty,
+                                   route1_after) +
+                 distance_on_nodes(m_prob, costs2, split2_after, m_tw_penalty,
+                                   route2_after);
+
+    // non-const: TransportationQuantity::operator- is a non-const member
+    auto demand1_before =
+             total_demand(m_prob, split1, route1.cbegin(), route1.cend()),
+         demand2_before =
+             total_demand(m_prob, split2, route2.cbegin(), route2.cend());
+    const auto demand_c = m_prob.customers[customer[0]].demand,
+               demand_n = m_prob.customers[neighbour[0]].demand;
+    const auto demand1_after = demand1_before - demand_c + demand_n,
+               demand2_after = demand2_before - demand_n + demand_c;
+    const auto route1_capacity =
+                   m_prob.vehicles[sln.routes[move.r1].first].capacity,
+               route2_capacity =
+                   m_prob.vehicles[sln.routes[move.r2].first].capacity;
+    cost.satisfies_capacity =
+        !(demand1_after > route1_capacity && demand1_after > demand1_before) &&
+        !(demand2_after > route2_capacity && demand2_after > demand2_before);
+
+    cost.satisfies_time_windows =
+        m_can_violate_tw ||
+        (tw_with_replaced(m_prob, split1_after, sln.tw_segments[move.r1],
+                          route1, c_index, c_index + 1, neighbour.cbegin(),
+                          neighbour.cend())
+             .satisfies_time_windows() &&
+         tw_with_replaced(m_prob, split2_after, sln.tw_segments[move.r2],
+                          route2, n_index, n_index + 1, customer.cbegin(),
+                          customer.cend())
+             .satisfies_time_windows());
+    return cost;
+}
+
+MoveCost LocalSearchMethods::evaluate(const Solution& sln,
+                                      const TwoOptMove& move) const {
+    const auto& route = sln.routes[move.route].second;
+    const auto& split = sln.route_splits[move.route];
+    const auto& costs = route_costs(m_prob, sln, move.route);
+    const auto i = move.first, k = move.last;
+
+    MoveCost cost;
+    // cost before: (i-1)->i->(i+1) + (k-1)->k->(k+1)
+    cost.before =
+        paired_distance_on_route(m_prob, costs, costs, split, split,
+                                 m_tw_penalty, atit(route, i), atit(route, k));
+    // cost after: (i-1)->k->(i+1) + (k-1)->i->(k+1) of the reversed route
+    const std::array<size_t, 3> nodes_i = {route[i - 1], route[k],
+                                           route[k - 1]};
+    const std::array<size_t, 3> nodes_k = {route[i + 1], route[i],
+                                           route[k + 1]};
+    cost.after =
+        distance_on_nodes(m_prob, costs, split, m_tw_penalty, nodes_i) +
+        distance_on_nodes(m_prob, costs, split, m_tw_penalty, nodes_k);
+
+    using reverse_iterator =
+        std::reverse_iterator<Solution::RouteType::const_iterator>;
+    cost.satisfies_time_windows =
+        m_can_violate_tw ||
+        tw_with_replaced(m_prob, split, sln.tw_segments[move.route], route, i,
+                         k + 1, reverse_iterator(atit(route, k + 1)),
+                         reverse_iterator(atit(route, i)))
+            .satisfies_time_windows();
+    return cost;
+}
+
+MoveCost LocalSearchMethods::evaluate(const Solution& sln,
+                                      const CrossMove& move) const {
+    const auto& route1 = sln.routes[move.r1].second;
+    const auto& route2 = sln.routes[move.r2].second;
+    const auto& split1 = sln.route_splits[move.r1];
+    const auto& split2 = sln.route_splits[move.r2];
+    const TransferredSplitInfo split1_after = {split1, split2};
+    const TransferredSplitInfo split2_after = {split2, split1};
+    const auto& segments1 = sln.tw_segments[move.r1];
+    const auto& segments2 = sln.tw_segments[move.r2];
+    const auto& costs1 = route_costs(m_prob, sln, move.r1);
+    const auto& costs2 = route_costs(m_prob, sln, move.r2);
+    const auto c_index = move.c_index, n_index = move.n_index;
+    const size_t customer = route1[c_index], neighbour = route2[n_index];
+    const size_t customer_next = route1[c_index + 1],
+                 neighbour_next = route2[n_index + 1];
+    const auto it1 = atit(route1, c_index), it2 = atit(route2, n_index);
+    const auto tail1 = std::next(it1), tail2 = std::next(it2);
+
+    // time windows of the tails are checked in O(1) using segments, route
+    // scan is only needed when violated
+    const auto start1 = constraints::tw_start_segment(m_prob, split1, customer);
+    const auto start2 =
+        constraints::tw_start_segment(m_prob, split2, neighbour);
+    const auto tail1_before = constraints::tw_concatenate(
+        m_prob, start1, customer, customer_next, segments1.backward[c_index + 1]);
+    const auto tail2_before = constraints::tw_concatenate(
+        m_prob, start2, neighbour, neighbour_next,
+        segments2.backward[n_index + 1]);
+    const auto tail1_after = constraints::tw_concatenate(
+        m_prob, start1, customer, neighbour_next,
+        segments2.backward[n_index + 1]);
+    const auto tail2_after = constraints::tw_concatenate(
+        m_prob, start2, neighbour, customer_next,
+        segments1.backward[c_index + 1]);
+
+    // violated time of a tail after the move: node followed by other tail
+    const auto violated_after = [this](const TransferredSplitInfo& info,
+                                       const TimeWindowSegment& segment,
+                                       size_t node, Route::const_iterator first,
+                                       Route::const_iterator last) {
+        if (segment.satisfies_time_windows()) {
+            return 0.0;
+        }
+        Route::container_type nodes;
+        nodes.reserve(std::distance(first, last) + 1);
+        nodes.emplace_back(node);
+        nodes.insert(nodes.cend(), first, last);
+        return violated_time(m_prob, info, m_tw_penalty, nodes.cbegin(),
+                             nodes.cend());
+    };
+
+    MoveCost cost;
+    cost.before =
+        distance_on_route(costs1,
+                          violated_time(m_prob, split1, m_tw_penalty,
+                                        tail1_before, it1, route1.cend()),
+                          it1, route1.cend()) +
+        distance_on_route(costs2,
+                          violated_time(m_prob, split2, m_tw_penalty,
+                                        tail2_before, it2, route2.cend()),
+                          it2, route2.cend());
+    // tails change vehicles: tail2 is served by route1's vehicle and vice versa
+    cost.after =
+        distance_on_joined_route(costs1,
+                                 violated_after(split1_after, tail1_after,
+                                                customer, tail2, route2.cend()),
+                                 customer, tail2, route2.cend()) +
+        distance_on_joined_route(costs2,
+                                 violated_after(split2_after, tail2_after,
+                                                neighbour, tail1, route1.cend()),
+                                 neighbour, tail1, route1.cend());
+
+    // non-const: TransportationQuantity::operator- is a non-const member
+    auto demand1_before =
+             total_demand(m_prob, split1, route1.cbegin(), route1.cend()),
+         demand2_before =
+             total_demand(m_prob, split2, route2.cbegin(), route2.cend());
+    const auto demand_tail1 =
+                   total_demand(m_prob, split1, tail1, route1.cend()),
+               demand_tail2 =
+                   total_demand(m_prob, split2, tail2, route2.cend());
+    const auto demand1_after = demand1_before - demand_tail1 + demand_tail2,
+               demand2_after = demand2_before - demand_tail2 + demand_tail1;
+    const auto route1_capacity =
+                   m_prob.vehicles[sln.routes[move.r1].first].capacity,
+               route2_capacity =
+                   m_prob.vehicles[sln.routes[move.r2].first].capacity;
+    cost.satisfies_capacity =
+        !(demand1_after > route1_capacity && demand1_after > demand1_before) &&
+        !(demand2_after > route2_capacity && demand2_after > demand2_before);
+
+    cost.satisfies_time_windows =
+        m_can_violate_tw ||
+        (tw_with_tail(m_prob, segments1, route1, c_index, segments2, route2,
+                      n_index + 1)
+             .satisfies_time_windows() &&
+         tw_with_tail(m_prob, segments2, route2, n_index, segments1, route1,
+                      c_index + 1)
+             .satisfies_time_windows());
+    return cost;
+}
+
+MoveCost LocalSearchMethods::evaluate(const Solution& sln,
+                                      const IntraSwapMove& move) const {
+    const auto& route = sln.routes[move.route].second;
+    const auto& split = sln.route_splits[move.route];
+    const auto& segments = sln.tw_segments[move.route];
+    const auto& costs = route_costs(m_prob, sln, move.route);
+    const auto a = move.first, b = move.second;
+    assert(a < b);
+
+    // route node at position p after the swap
+    const auto node = [&route, a, b](size_t p) {
+        return p == a ? route[b] : (p == b ? route[a] : route[p]);
+    };
+
+    // time window segment of the route after the swap
+    auto segment = constraints::tw_concatenate(
+        m_prob, segments.forward[a - 1], route[a - 1], route[b],
+        constraints::tw_segment(m_prob, split, route[b]));
+    if (b > a + 1) {
+        segment = constraints::tw_concatenate(
+            m_prob, segment, route[b], route[a + 1],
+            constraints::tw_segment(m_prob, split, atit(route, a + 1),
+                                    atit(route, b)));
+    }
+    segment = constraints::tw_concatenate(
+        m_prob, segment, node(b - 1), route[a],
+        constraints::tw_segment(m_prob, split, route[a]));
+    segment = constraints::tw_concatenate(m_prob, segment, route[a],
+                                          route[b + 1], segments.backward[b + 1]);
+
+    MoveCost cost;
+    // violated time of the whole route is known from segments
+    cost.before = distance_on_route(
+        costs, m_tw_penalty * segments.forward.back().violated_time,
+        route.cbegin(), route.cend());
+
+    double violation = 0.0;
+    if (!segment.satisfies_time_windows()) {
+        Route::container_type swapped(route.cbegin(), route.cend());
+        std::swap(swapped[a], swapped[b]);
+        violation = violated_time(m_prob, split, m_tw_penalty, swapped.cbegin(),
+                                  swapped.cend());
+    }
+    cost.after = violation;
+    for (size_t p = 0, size = route.size(); p + 1 < size; ++p) {
+        cost.after += costs(node(p), node(p + 1));
+    }
+
+    cost.satisfies_time_windows =
+        m_can_violate_tw || segment.satisfies_time_windows();
+    return cost;
+}
+
+MoveCost LocalSearchMethods::evaluate(const Solution& sln,
+                                      const MergeSplitMove& move) const {
+    const auto& route_in = sln.routes[move.r_in].second;
+    const auto& route_out = sln.routes[move.r_out].second;
+    const auto& split_in = sln.route_splits[move.r_in];
+    const auto& split_out = sln.route_splits[move.r_out];
+    const auto c_in = move.c_in, c_out = move.c_out;
+    const std::array<size_t, 1> customer = {move.customer};
+    // customer ratio, so its service time, changes in route_out
+    const ReplacedSplitInfo split_out_after = {
+        split_out, move.customer,
+        SplitInfo::Split(m_prob.customers[move.customer],
+                         split_out.at(move.customer) +
+                             split_in.at(move.customer))};
+    const auto& costs_in = route_costs(m_prob, sln, move.r_in);
+    const auto& costs_out = route_costs(m_prob, sln, move.r_out);
+
+    MoveCost cost;
+    cost.before = distance_on_route(m_prob, costs_in, split_in, m_tw_penalty,
+                                    route_in, c_in - 1, c_in + 2) +
+                  distance_on_route(m_prob, costs_out, split_out, m_tw_penalty,
+                                    route_out, c_out - 1, c_out + 2);
+
+    const std::array<size_t, 2> in_after = {route_in[c_in - 1],
+                                            route_in[c_in + 1]};
+    cost.after =
+        distance_on_nodes(m_prob, costs_in, split_in, m_tw_penalty, in_after) +
+        distance_on_route(m_prob, costs_out, split_out_after, m_tw_penalty,
+                          atit(route_out, c_out - 1),
+                          atit(route_out, c_out + 2));
+
+    const auto out_demand_after = total_demand(
+        m_prob, split_out_after, route_out.cbegin(), route_out.cend());
+    const auto out_capacity =
+        m_prob.vehicles[sln.routes[move.r_out].first].capacity;
+    cost.satisfies_capacity = !(out_demand_after > out_capacity);
+
+    cost.satisfies_time_windows =
+        m_can_violate_tw ||
+        tw_with_replaced(m_prob, split_out_after, sln.tw_segments[move.r_out],
+                         route_out, c_out, c_out + 1, customer.cbegin(),
+                         customer.cend())
+            .satisfies_time_windows();
+    return cost;
+}
+
+void LocalSearchMethods::apply(Solution& sln, const RelocateMove& move) const {
+    auto& route_in = sln.routes[move.r_in].second;
+    auto& route_out = sln.routes[move.r_out].second;
+    route_out.insert(move.insert_index, move.customer);
+    transfer_split_entry(m_enable_splits, sln.route_splits[move.r_in],
+                         sln.route_splits[move.r_out], move.customer);
+    route_in.erase(move.c_index);
+
+    sln.customer_owners.erase(move.customer, move.r_in);
+    sln.update_customer_owners(m_prob, move.r_in, move.c_index);
+    sln.update_customer_owners(m_prob, move.r_out, move.n_index - 1);
+    sln.update_tw_segments(m_prob, move.r_in);
+    sln.update_tw_segments(m_prob, move.r_out);
+}
+
+void LocalSearchMethods::apply(Solution& sln, const NewRouteMove& move) const {
+    sln.routes.emplace_back(move.vehicle, add_depots({move.customer}));
+    sln.route_splits.emplace_back(m_default_split_info);
+    const size_t r_out = sln.routes.size() - 1;
+    transfer_split_entry(m_enable_splits, sln.route_splits[move.r_in],
+                         sln.route_splits[r_out], move.customer);
+    sln.routes[move.r_in].second.erase(move.c_index);
+
+    sln.customer_owners.erase(move.customer, move.r_in);
+    sln.update_customer_owners(m_prob, move.r_in, move.c_index);
+    sln.update_customer_owners(m_prob, r_out);
+    sln.used_vehicles.emplace(move.vehicle);
+    sln.update_tw_segments(m_prob, move.r_in);
+    sln.update_tw_segments(m_prob, r_out);
+}
+
+void LocalSearchMethods::apply(Solution& sln, const ExchangeMove& move) const {
+    auto& route1 = sln.routes[move.r1].second;
+    auto& route2 = sln.routes[move.r2].second;
+    const size_t customer = route1[move.c_index],
+                 neighbour = route2[move.n_index];
+    route1.set(move.c_index, neighbour);
+    route2.set(move.n_index, customer);
+    transfer_split_entry(m_enable_splits, sln.route_splits[move.r1],
+                         sln.route_splits[move.r2], customer);
+    transfer_split_entry(m_enable_splits, sln.route_splits[move.r2],
+                         sln.route_splits[move.r1], neighbour);
+
+    sln.customer_owners.erase(customer, move.r1);
+    sln.customer_owners.erase(neighbour, move.r2);
+    sln.customer_owners.set(customer, move.r2, move.n_index);
+    sln.customer_owners.set(neighbour, move.r1, move.c_index);
+    sln.update_tw_segments(m_prob, move.r1);
+    sln.update_tw_segments(m_prob, move.r2);
+}
+
+void LocalSearchMethods::apply(Solution& sln, const TwoOptMove& move) const {
+    sln.routes[move.route].second.reverse(move.first, move.last + 1);
+    sln.update_customer_owners(m_prob, move.route, move.first);
+    sln.update_tw_segments(m_prob, move.route);
+}
+
+void LocalSearchMethods::apply(Solution& sln, const CrossMove& move) const {
+    auto& route1 = sln.routes[move.r1].second;
+    auto& route2 = sln.routes[move.r2].second;
+    const auto tail1 = atit(route1, move.c_index + 1),
+               tail2 = atit(route2, move.n_index + 1);
+    for (auto it = tail1; it != route1.end(); ++it) {
+        sln.customer_owners.erase(*it, move.r1);
+    }
+    for (auto it = tail2; it != route2.end(); ++it) {
+        sln.customer_owners.erase(*it, move.r2);
+    }
+    transfer_split_entry(m_enable_splits, sln.route_splits[move.r1],
+                         sln.route_splits[move.r2], tail1, route1.end());
+    transfer_split_entry(m_enable_splits, sln.route_splits[move.r2],
+                         sln.route_splits[move.r1], tail2, route2.end());
+    swap_tails(route1, move.c_index + 1, route2, move.n_index + 1);
+
+    sln.update_customer_owners(m_prob, move.r1, move.c_index);
+    sln.update_customer_owners(m_prob, move.r2, move.n_index);
+    sln.update_tw_segments(m_prob, move.r1);
+    sln.update_tw_segments(m_prob, move.r2);
+}
+
+void LocalSearchMethods::apply(Solution& sln, const IntraSwapMove& move) const {
+    auto& route = sln.routes[move.route].second;
+    route.swap_nodes(move.first, move.second);
+    sln.update_customer_owners(m_prob, move.route, move.first);
+    sln.update_tw_segments(m_prob, move.route);
+}
+
+void LocalSearchMethods::apply(Solution& sln,
+                               const MergeSplitMove& move) const {
+    auto& split_in = sln.route_splits[move.r_in];
+    auto& split_out = sln.route_splits[move.r_out];
+    const auto& customer = m_prob.customers[move.customer];
+    split_out.set(customer, split_out.at(move.customer) +
+                                split_in.at(move.customer));
+    split_in.split_info.erase(move.customer);
+    sln.routes[move.r_in].second.erase(move.c_in);
+
+    sln.customer_owners.erase(move.customer, move.r_in);
+    sln.update_customer_owners(m_prob, move.r_in, move.c_in);
+    sln.update_tw_segments(m_prob, move.r_in);
+    sln.update_tw_segments(m_prob, move.r_out);
+}
+
 bool LocalSearchMethods::relocate(Solution& sln, TabuLists& lists,
                                   size_t method_id) {
+    PERF_OPERATOR_TIMER(Relocate);
     auto& best_ever_value = m_best_values[method_id];
 
     bool improved = false;
+    sln.update_tw_segments(m_prob);
 
     // reminder: skip depot!
     const auto& customers = m_prob.customers;
@@ -450,12 +1072,13 @@ bool LocalSearchMethods::relocate(Solution& sln, TabuLists& lists,
             size_t r_in = 0, c_index = 0;
             std::tie(r_in, c_index) = *cfirst;
             validate_indices(r_in, c_index, sln.routes);
-            auto& route_in = sln.routes[r_in].second;
+            const auto& route_in = sln.routes[r_in].second;
             if (is_loop(route_in)) {
                 continue;
             }
-            SplitInfo& split_in = sln.route_splits[r_in];
-            for (size_t neighbour : descending_sort_customers) {
+            const SplitInfo& split_in = sln.route_splits[r_in];
+            for (size_t neighbour :
+                 neighbours(m_prob, customer, descending_sort_customers)) {
                 if (skip_to_next_customer) {
                     break;
                 }
@@ -474,7 +1097,7 @@ bool LocalSearchMethods::relocate(Solution& sln, TabuLists& lists,
                         continue;
                     }
 
-                    auto& route_out = sln.routes[r_out].second;
+                    const auto& route_out = sln.routes[r_out].second;
                     if (is_loop(route_out)) {
                         continue;
                     }
@@ -484,7 +1107,7 @@ bool LocalSearchMethods::relocate(Solution& sln, TabuLists& lists,
                         continue;
                     }
 
-                    SplitInfo& split_out = sln.route_splits[r_out];
+                    const SplitInfo& split_out = sln.route_splits[r_out];
                     // FIXME: allow such moves?
                     if (m_enable_splits && split_out.has(customer)) {
                         continue;
@@ -493,17 +1116,18 @@ bool LocalSearchMethods::relocate(Solution& sln, TabuLists& lists,
                     // customer value represents the length of route i -> j,
                     // where:
                     // ... -> (i -> customer -> j) -> ...
-                    const auto customer_value =
-                        distance_on_route(m_prob, split_in, 0, route_in,
-                                          c_index - 1, c_index + 2);
+                    const auto& costs_out = route_costs(m_prob, sln, r_out);
+                    const auto customer_value = distance_on_route(
+                        m_prob, route_costs(m_prob, sln, r_in), split_in, 0,
+                        route_in, c_index - 1, c_index + 2);
                     const auto customer_neighbour_distance =
-                        m_prob.costs[customer][neighbour];
+                        costs_out(customer, neighbour);
                     const auto customer_before_neighbour_value =
                         customer_neighbour_distance +
-                        m_prob.costs[customer][at(route_out, n_index - 1)];
+                        costs_out(customer, route_out.at(n_index - 1));
                     const auto customer_after_neighbour_value =
                         customer_neighbour_distance +
-                        m_prob.costs[customer][at(route_out, n_index + 1)];
+                        costs_out(customer, route_out.at(n_index + 1));
 
                     // if customer is closer to it's neighbours in __current__
                     // route, do not relocate to neighbours in __new__ route
@@ -514,93 +1138,46 @@ bool LocalSearchMethods::relocate(Solution& sln, TabuLists& lists,
 
                     // we assume there's a better place for our customer at this
                     // point
-
-                    auto it_in_before = atit(route_in, c_index - 1),
-                         it_in_after = atit(route_in, c_index + 1),
-                         it_out_before = atit(route_out, n_index - 1),
-                         it_out_after = atit(route_out, n_index + 1);
-
-                    const auto cost_before =
-                        distance_on_route(m_prob, split_in, m_tw_penalty,
-                                          it_in_before,
-                                          std::next(it_in_after)) +
-                        distance_on_route(m_prob, split_out, m_tw_penalty,
-                                          it_out_before,
-                                          std::next(it_out_after));
-
-                    Solution::RouteType::iterator inserted, erased;
-                    if (customer_before_neighbour_value <
-                        customer_after_neighbour_value) {
-                        inserted = route_out.insert(std::next(it_out_before),
-                                                    customer);
-                    } else {
-                        inserted = route_out.insert(it_out_after, customer);
-                    }
-
-                    transfer_split_entry(m_enable_splits, split_in, split_out,
-                                         customer);
-
-                    erased = route_in.erase(std::next(it_in_before));
-
-                    const auto cost_after =
-                        distance_on_route(m_prob, split_in, m_tw_penalty,
-                                          it_in_before,
-                                          std::next(it_in_after)) +
-                        distance_on_route(m_prob, split_out, m_tw_penalty,
-                                          it_out_before,
-                                          std::next(it_out_after));
-
-                    const auto out_demand_after =
-                        total_demand(m_prob, split_out, route_out.cbegin(),
-                                     route_out.cend());
+                    const size_t insert_index =
+                        customer_before_neighbour_value <
+                                customer_after_neighbour_value
+                            ? n_index
+                            : n_index + 1;
+                    const RelocateMove move = {customer, r_in,    c_index,
+                                               r_out,    n_index, insert_index};
+                    const auto cost = evaluate(sln, move);
 
                     // aspiration criteria
                     bool impossible_move =
                         (lists.relocate.has(customer, r_out) ||
                          lists.pr_relocate.has(customer, r_in)) &&
-                        cost_after >= best_ever_value;
-
-                    const auto out_capacity =
-                        m_prob.vehicles[sln.routes[r_out].first].capacity;
-                    impossible_move |= (out_demand_after > out_capacity);
-
-                    impossible_move |=
-                        (!m_can_violate_tw &&
-                         (constraints::total_violated_time(
-                              m_prob, split_out, route_out.cbegin(),
-                              route_out.cend()) != 0));
+                        cost.after >= best_ever_value;
+                    impossible_move |= !cost.feasible();
+                    COUNT_MOVE(Relocate, impossible_move, cost);
 
                     // decide whether move is good
-                    if (!impossible_move && cost_after < cost_before) {
+                    if (!impossible_move && cost.after < cost.before) {
                         // move is good
-                        sln.customer_owners[customer].erase(r_in);
-                        sln.update_customer_owners(m_prob, r_in, c_index);
-                        sln.update_customer_owners(m_prob, r_out, n_index - 1);
+                        apply(sln, move);
                         lists.relocate.emplace(customer, r_in);
 #if USE_PRESERVE_ENTRIES
                         lists.pr_relocate.emplace(customer, r_out);
 #endif
-                        best_ever_value = std::min(best_ever_value, cost_after);
+                        best_ever_value = std::min(best_ever_value, cost.after);
                         improved = true;
                         skip_to_next_customer = true;
-                    } else {
-                        // move is bad - roll back the changes
-                        route_in.insert(erased, customer);
-                        route_out.erase(inserted);
-                        transfer_split_entry(m_enable_splits, split_out,
-                                             split_in, customer);
                     }
                 }
             }
         }
     }
     delete_loops_after_relocate(sln, lists);
-    sln.update_customer_owners(m_prob);
     return improved;
 }
 
 bool LocalSearchMethods::relocate_new_route(Solution& sln, TabuLists& lists,
                                             size_t method_id) {
+    PERF_OPERATOR_TIMER(RelocateNewRoute);
     auto& best_ever_value = m_best_values[method_id];
 
     const auto vehicles_size = m_prob.n_vehicles();
@@ -621,6 +1198,7 @@ bool LocalSearchMethods::relocate_new_route(Solution& sln, TabuLists& lists,
     }
 
     bool improved = false;
+    sln.update_tw_segments(m_prob);
 
     // reminder: skip depot!
     const auto& customers = m_prob.customers;
@@ -650,87 +1228,49 @@ bool LocalSearchMethods::relocate_new_route(Solution& sln, TabuLists& lists,
             }
 
             // find suitable vehicle
-            bool found_suitable_vehicle = false;
-            size_t used_vehicle = std::numeric_limits<size_t>::max();
-            for (auto v : unused_vehicles) {
-                const bool enough_capacity = m_prob.vehicles[v].capacity >=
-                                             m_prob.customers[customer].demand;
-                if (enough_capacity && site_dependent(m_prob, v, customer)) {
-                    sln.routes.emplace_back(v, add_depots({customer}));
-                    used_vehicle = v;
-                    unused_vehicles.erase(v);  // TODO: is it safe though?
-                    found_suitable_vehicle = true;
-                    break;
-                }
-            }
-            if (!found_suitable_vehicle) {
+            const auto vehicle = std::find_if(
+                unused_vehicles.cbegin(), unused_vehicles.cend(),
+                [this, customer](size_t v) {
+                    return m_prob.vehicles[v].capacity >=
+                               m_prob.customers[customer].demand &&
+                           site_dependent(m_prob, v, customer);
+                });
+            if (vehicle == unused_vehicles.cend()) {
                 continue;
             }
-            assert(used_vehicle != std::numeric_limits<size_t>::max());
 
             // we assume there's a suitable vehicle at this point
-            auto& route_in = sln.routes[r_in].second;
-
-            sln.route_splits.emplace_back(m_default_split_info);
-            SplitInfo& split_in = sln.route_splits[r_in];
-            SplitInfo& split_out = sln.route_splits.back();
-
-            auto it_in_before = atit(route_in, c_index - 1),
-                 it_in_after = atit(route_in, c_index + 1),
-                 it_out = atit(sln.routes.back().second, 1);
-
-            const auto cost_before =
-                distance_on_route(m_prob, split_in, m_tw_penalty, it_in_before,
-                                  std::next(it_in_after));
-
-            transfer_split_entry(m_enable_splits, split_in, split_out,
-                                 customer);
-
-            auto erased = route_in.erase(std::next(it_in_before));
-
-            const auto cost_after =
-                distance_on_route(m_prob, split_in, m_tw_penalty, it_in_before,
-                                  std::next(it_in_after)) +
-                distance_on_route(m_prob, split_out, m_tw_penalty,
-                                  std::prev(it_out), std::next(it_out, 2));
+            const NewRouteMove move = {customer, r_in, c_index, *vehicle};
+            const auto cost = evaluate(sln, move);
 
             const bool impossible_move =
                 lists.pr_relocate_new_route.has(customer, r_in) &&
-                cost_after >= best_ever_value;
+                cost.after >= best_ever_value;
+            COUNT_MOVE(RelocateNewRoute, impossible_move, cost);
 
             // decide whether move is good
-            if (!impossible_move && cost_after < cost_before) {
+            if (!impossible_move && cost.after < cost.before) {
                 // move is good
-                size_t r_out = sln.routes.size() - 1;
-                sln.customer_owners[customer].erase(r_in);
-                sln.update_customer_owners(m_prob, r_in, c_index);
-                sln.update_customer_owners(m_prob, r_out);
-                sln.used_vehicles.emplace(used_vehicle);
+                apply(sln, move);
+                unused_vehicles.erase(vehicle);
                 lists.relocate_new_route.emplace(customer, r_in);
 #if USE_PRESERVE_ENTRIES
-                lists.pr_relocate_new_route.emplace(customer, r_out);
+                lists.pr_relocate_new_route.emplace(customer,
+                                                    sln.routes.size() - 1);
 #endif
-                best_ever_value = cost_after;
+                best_ever_value = cost.after;
                 improved = true;
                 skip_to_next_customer = true;
-            } else {
-                // move is bad - roll back the changes
-                route_in.insert(erased, customer);
-                sln.routes.pop_back();
-                unused_vehicles.emplace(used_vehicle);
-                transfer_split_entry(m_enable_splits, split_out, split_in,
-                                     customer);
-                sln.route_splits.pop_back();
             }
         }
     }
     delete_loops_after_relocate(sln, lists);
-    sln.update_customer_owners(m_prob);
     return improved;
 }
 
 bool LocalSearchMethods::relocate_split(Solution& sln, TabuLists& lists,
                                         size_t method_id) {
+    PERF_OPERATOR_TIMER(RelocateSplit);
     if (!m_prob.enable_splits()) {
         return false;
     }
@@ -743,7 +1283,7 @@ bool LocalSearchMethods::relocate_split(Solution& sln, TabuLists& lists,
         const auto& route_split = sln.route_splits[ri].split_info;
         for (const auto& p : route_split) {
             // only store split customers
-            if (p.second > 0.0 && p.second < 1.0) {
+            if (p.second.ratio.partial()) {
                 split_customers.emplace(p.first);
             }
         }
@@ -781,24 +1321,29 @@ bool LocalSearchMethods::relocate_split(Solution& sln, TabuLists& lists,
                 }
 
                 SplitInfo& split_out = sln.route_splits[r_out];
+                const auto& costs_in = route_costs(m_prob, sln, r_in);
+                const auto& costs_out = route_costs(m_prob, sln, r_out);
 
                 // TODO: doing copy here. seems to hard without it
                 auto route_in_orig = sln.routes[r_in].second;
                 auto& route_in = sln.routes[r_in].second;
 
                 const auto cost_before =
-                    distance_on_route(m_prob, split_in, m_tw_penalty,
+                    distance_on_route(m_prob, costs_in, split_in, m_tw_penalty,
                                       route_in.cbegin(), route_in.cend()) +
-                    distance_on_route(m_prob, split_out, m_tw_penalty,
-                                      route_out.cbegin(), route_out.cend());
+                    distance_on_route(m_prob, costs_out, split_out,
+                                      m_tw_penalty, route_out.cbegin(),
+                                      route_out.cend());
 
                 // erase split customer from route_in -> perform split merge
-                auto erased_ratio = split_in.at(customer);
+                const auto& customer_info = m_prob.customers[customer];
+                const auto erased_ratio = split_in.at(customer);
 
                 split_in.split_info.erase(customer);
-                split_out.split_info.at(customer) += erased_ratio;
+                split_out.set(customer_info,
+                              split_out.at(customer) + erased_ratio);
 
-                route_in.erase(atit(route_in, c_in));
+                route_in.erase(c_in);
 
                 // if loop occured, find non-split neighbour closest to depot
                 const bool loop_occured = is_loop(route_in);
@@ -818,8 +1363,9 @@ bool LocalSearchMethods::relocate_split(Solution& sln, TabuLists& lists,
                 }
                 if (neighbour_it_in == route_out.end()) {
                     sln.routes[r_in].second = std::move(route_in_orig);
-                    split_in.split_info[customer] = erased_ratio;
-                    split_out.split_info.at(customer) -= erased_ratio;
+                    split_in.set(customer_info, erased_ratio);
+                    split_out.set(customer_info,
+                                  split_out.at(customer) - erased_ratio);
                     continue;
                 }
 
@@ -830,8 +1376,9 @@ bool LocalSearchMethods::relocate_split(Solution& sln, TabuLists& lists,
                     !site_dependent(m_prob, sln.routes[r_in].first,
                                     neighbour)) {
                     sln.routes[r_in].second = std::move(route_in_orig);
-                    split_in.split_info[customer] = erased_ratio;
-                    split_out.split_info.at(customer) -= erased_ratio;
+                    split_in.set(customer_info, erased_ratio);
+                    split_out.set(customer_info,
+                                  split_out.at(customer) - erased_ratio);
                     continue;
                 }
 
@@ -841,9 +1388,9 @@ bool LocalSearchMethods::relocate_split(Solution& sln, TabuLists& lists,
                     route_in.insert(std::next(neighbour_it_out), neighbour);
                 } else {
                     const auto before_value =
-                        m_prob.costs[neighbour][*std::prev(neighbour_it_out)];
+                        costs_in(neighbour, *std::prev(neighbour_it_out));
                     const auto after_value =
-                        m_prob.costs[neighbour][*std::next(neighbour_it_out)];
+                        costs_in(neighbour, *std::next(neighbour_it_out));
 
                     // split neighbour in 2 parts
                     if (before_value < after_value) {
@@ -853,46 +1400,45 @@ bool LocalSearchMethods::relocate_split(Solution& sln, TabuLists& lists,
                     }
                 }
 
+                const auto& neighbour_info = m_prob.customers[neighbour];
+                const int neighbour_units =
+                    SplitInfo::Ratio::total_units(neighbour_info);
 #if RELOCATE_SPLIT_SAME_VOLUME
                 // __the same__ volume of neighbour (as was for customer) goes
                 // to new route: but the ratio changes!
-
-                // Note: proper ratios are ensured so erased volume is always
-                //       int. anyway, there's a std::round() to make double
-                //       arithmetics less noisy
-                const double erased_volume = std::round(
-                    erased_ratio * m_prob.customers[customer].demand.volume);
-                double inserted_ratio =
-                    erased_volume / m_prob.customers[neighbour].demand.volume;
+                const auto inserted_ratio =
+                    SplitInfo::Ratio::of(neighbour_info, erased_ratio.units);
 
                 // cannot relocate if erased volume > inserted volume or
                 // inserted ratio < threshold
                 const bool impossible_relocate =
-                    static_cast<int>(erased_volume) >
-                        m_prob.customers[neighbour].demand.volume ||
-                    inserted_ratio < m_prob.split_thr;
-
-                // fix ratio if insertion is impossible
-                inserted_ratio = impossible_relocate ? 0.0 : inserted_ratio;
+                    !inserted_ratio.partial() ||
+                    inserted_ratio.value() < m_prob.split_thr;
 #else
-                // use the same ratio: this breaks aligned ratios (aligned by
-                // integer volume), but gives more room for improvement. also,
-                // std::ceil() is used everywhere, so it's safe _not_ to modify
-                // the value here
-                const auto& inserted_ratio = erased_ratio;
-
-                // can do relocate split always
-                static constexpr const bool impossible_relocate = false;
+                // use the same ratio, rounded to units of neighbour demand:
+                // this breaks aligned ratios (aligned by integer volume), but
+                // gives more room for improvement
+                const auto inserted_ratio = SplitInfo::Ratio::of(
+                    neighbour_info,
+                    static_cast<int>((int64_t(erased_ratio.units) *
+                                          neighbour_units * 2 +
+                                      erased_ratio.total) /
+                                     (int64_t(erased_ratio.total) * 2)));
+
+                // cannot relocate if rounding leaves nothing to split
+                const bool impossible_relocate = !inserted_ratio.partial();
 #endif
 
-                split_in.split_info[neighbour] = inserted_ratio;
-                split_out.split_info.at(neighbour) -= inserted_ratio;
+                split_in.set(neighbour_info, inserted_ratio);
+                split_out.set(neighbour_info,
+                              split_out.at(neighbour) - inserted_ratio);
 
                 const auto cost_after =
-                    distance_on_route(m_prob, split_in, m_tw_penalty,
+                    distance_on_route(m_prob, costs_in, split_in, m_tw_penalty,
                                       route_in.cbegin(), route_in.cend()) +
-                    distance_on_route(m_prob, split_out, m_tw_penalty,
-                                      route_out.cbegin(), route_out.cend());
+                    distance_on_route(m_prob, costs_out, split_out,
+                                      m_tw_penalty, route_out.cbegin(),
+                                      route_out.cend());
 
                 const auto in_demand_after = total_demand(
                     m_prob, split_in, route_in.cbegin(), route_in.cend());
@@ -913,24 +1459,31 @@ bool LocalSearchMethods::relocate_split(Solution& sln, TabuLists& lists,
                     m_prob.vehicles[sln.routes[r_in].first].capacity;
                 const auto out_capacity =
                     m_prob.vehicles[sln.routes[r_out].first].capacity;
-                impossible_move |= (in_demand_after > in_capacity) ||
-                                   (out_demand_after > out_capacity);
-
-                impossible_move |=
-                    (!m_can_violate_tw &&
-                     (constraints::total_violated_time(m_prob, split_in,
-                                                       route_in.cbegin(),
-                                                       route_in.cend()) != 0 ||
-                      constraints::total_violated_time(m_prob, split_out,
-                                                       route_out.cbegin(),
-                                                       route_out.cend()) != 0));
+                const bool satisfies_capacity =
+                    !((in_demand_after > in_capacity) ||
+                      (out_demand_after > out_capacity));
+                impossible_move |= !satisfies_capacity;
+
+                const bool satisfies_time_windows =
+                    m_can_violate_tw ||
+                    (constraints::total_violated_time(m_prob, split_in,
+                                                      route_in.cbegin(),
+                                                      route_in.cend()) == 0 &&
+                     constraints::total_violated_time(m_prob, split_out,
+                                                      route_out.cbegin(),
+                                                      route_out.cend()) == 0);
+                impossible_move |= !satisfies_time_windows;
 
                 impossible_move |= impossible_relocate;
+                COUNT_MOVE(RelocateSplit, impossible_move,
+                           (MoveCost{cost_before, cost_after,
+                                     satisfies_capacity,
+                                     satisfies_time_windows}));
 
                 // decide whether move is good
                 if (!impossible_move && cost_after < cost_before) {
                     // move is good
-                    sln.customer_owners[customer].erase(r_in);
+                    sln.customer_owners.erase(customer, r_in);
                     sln.update_customer_owners(m_prob, r_in);
                     lists.relocate_split.emplace(customer, r_in);
                     lists.relocate_split.emplace(neighbour, r_out);
@@ -944,24 +1497,27 @@ bool LocalSearchMethods::relocate_split(Solution& sln, TabuLists& lists,
                 } else {
                     // move is bad - roll back the changes
                     sln.routes[r_in].second = std::move(route_in_orig);
-                    split_in.split_info[customer] = erased_ratio;
-                    split_out.split_info.at(customer) -= erased_ratio;
+                    split_in.set(customer_info, erased_ratio);
+                    split_out.set(customer_info,
+                                  split_out.at(customer) - erased_ratio);
                     split_in.split_info.erase(neighbour);
-                    split_out.split_info.at(neighbour) += inserted_ratio;
+                    split_out.set(neighbour_info,
+                                  split_out.at(neighbour) + inserted_ratio);
                 }
             }
         }
     }
     delete_loops_after_relocate(sln, lists);
-    sln.update_customer_owners(m_prob);
     return improved;
 }
 
 bool LocalSearchMethods::exchange(Solution& sln, TabuLists& lists,
                                   size_t method_id) {
+    PERF_OPERATOR_TIMER(Exchange);
     auto& best_ever_value = m_best_values[method_id];
 
     bool improved = false;
+    sln.update_tw_segments(m_prob);
 
     // reminder: skip depot!
     const auto& customers = m_prob.customers;
@@ -985,12 +1541,12 @@ bool LocalSearchMethods::exchange(Solution& sln, TabuLists& lists,
             size_t r1 = 0, c_index = 0;
             std::tie(r1, c_index) = *cfirst;
             validate_indices(r1, c_index, sln.routes);
-            auto& route1 = sln.routes[r1].second;
-            if (is_loop(route1)) {
+            if (is_loop(sln.routes[r1].second)) {
                 continue;
             }
-            SplitInfo& split1 = sln.route_splits[r1];
-            for (size_t neighbour : ascending_sort_customers) {
+            const SplitInfo& split1 = sln.route_splits[r1];
+            for (size_t neighbour :
+                 neighbours(m_prob, customer, ascending_sort_customers)) {
                 if (skip_to_next_customer) {
                     break;
                 }
@@ -1009,8 +1565,7 @@ bool LocalSearchMethods::exchange(Solution& sln, TabuLists& lists,
                         continue;
                     }
 
-                    auto& route2 = sln.routes[r2].second;
-                    if (is_loop(route2)) {
+                    if (is_loop(sln.routes[r2].second)) {
                         continue;
                     }
 
@@ -1023,93 +1578,41 @@ bool LocalSearchMethods::exchange(Solution& sln, TabuLists& lists,
                         continue;
                     }
 
-                    SplitInfo& split2 = sln.route_splits[r2];
+                    const SplitInfo& split2 = sln.route_splits[r2];
                     // FIXME: allow such moves?
                     if (m_enable_splits &&
                         (split2.has(customer) || split1.has(neighbour))) {
                         continue;
                     }
 
-                    // we assume we can exchange two iterators at this point
-
-                    // perform exchange (just swap customer indices)
-                    auto it1 = atit(route1, c_index),
-                         it2 = atit(route2, n_index);
-                    const auto cost_before = paired_distance_on_route(
-                        m_prob, split1, split2, m_tw_penalty, it1, it2);
-
-                    auto demand1_before = total_demand(
-                             m_prob, split1, route1.cbegin(), route1.cend()),
-                         demand2_before = total_demand(
-                             m_prob, split2, route2.cbegin(), route2.cend());
-                    auto demand_it1 = m_prob.customers[*it1].demand,
-                         demand_it2 = m_prob.customers[*it2].demand;
-
-                    std::swap(*it1, *it2);
-
-                    transfer_split_entry(m_enable_splits, split1, split2,
-                                         customer);
-                    transfer_split_entry(m_enable_splits, split2, split1,
-                                         neighbour);
-
-                    const auto cost_after = paired_distance_on_route(
-                        m_prob, split1, split2, m_tw_penalty, it1, it2);
-
-                    const auto demand1_after =
-                                   demand1_before - demand_it1 + demand_it2,
-                               demand2_after =
-                                   demand2_before - demand_it2 + demand_it1;
+                    // we assume we can exchange two customers at this point
+                    const ExchangeMove move = {r1, c_index, r2, n_index};
+                    const auto cost = evaluate(sln, move);
 
                     // aspiration criteria
                     bool impossible_move =
                         (lists.exchange.has(customer, r2) ||
                          lists.pr_exchange.has(customer, r1)) &&
-                        cost_after >= best_ever_value;
+                        cost.after >= best_ever_value;
                     impossible_move |= (lists.exchange.has(neighbour, r1) ||
                                         lists.pr_exchange.has(neighbour, r2)) &&
-                                       cost_after >= best_ever_value;
-
-                    const auto
-                        route1_capacity =
-                            m_prob.vehicles[sln.routes[r1].first].capacity,
-                        route2_capacity =
-                            m_prob.vehicles[sln.routes[r2].first].capacity;
-                    impossible_move |= (demand1_after > route1_capacity &&
-                                        demand1_after > demand1_before);
-                    impossible_move |= (demand2_after > route2_capacity &&
-                                        demand2_after > demand2_before);
-
-                    impossible_move |= (!m_can_violate_tw &&
-                                        (constraints::total_violated_time(
-                                             m_prob, split1, route1.cbegin(),
-                                             route1.cend()) != 0 ||
-                                         constraints::total_violated_time(
-                                             m_prob, split2, route2.cbegin(),
-                                             route2.cend()) != 0));
+                                       cost.after >= best_ever_value;
+                    impossible_move |= !cost.feasible();
+                    COUNT_MOVE(Exchange, impossible_move, cost);
 
                     // decide whether move is good
-                    if (!impossible_move && cost_after < cost_before) {
+                    if (!impossible_move && cost.after < cost.before) {
                         // move is good
-                        sln.customer_owners[customer].erase(r1);
-                        sln.customer_owners[neighbour].erase(r2);
-                        sln.customer_owners[customer][r2] = n_index;
-                        sln.customer_owners[neighbour][r1] = c_index;
+                        apply(sln, move);
                         lists.exchange.emplace(customer, r1);
                         lists.exchange.emplace(neighbour, r2);
 #if USE_PRESERVE_ENTRIES
                         lists.pr_exchange.emplace(customer, r2);
                         lists.pr_exchange.emplace(neighbour, r1);
 #endif
-                        best_ever_value = std::min(best_ever_value, cost_after);
+                        best_ever_value = std::min(best_ever_value, cost.after);
                         improved = true;
                         skip_to_next_customer = true;
-                    } else {
-                        // move is bad - roll back the changes
-                        std::swap(*it1, *it2);
-                        transfer_split_entry(m_enable_splits, split2, split1,
-                                             customer);
-                        transfer_split_entry(m_enable_splits, split1, split2,
-                                             neighbour);
                     }
                 }
             }
@@ -1120,65 +1623,52 @@ bool LocalSearchMethods::exchange(Solution& sln, TabuLists& lists,
 
 bool LocalSearchMethods::two_opt(Solution& sln, TabuLists& lists,
                                  size_t method_id) {
+    PERF_OPERATOR_TIMER(TwoOpt);
     auto& best_ever_value = m_best_values[method_id];
 
     bool improved = false;
+    sln.update_tw_segments(m_prob);
 
     for (size_t ri = 0; ri < sln.routes.size(); ++ri) {
-        auto& route = sln.routes[ri].second;
+        const auto& route = sln.routes[ri].second;
+        const size_t size = route.size();
 
         // Note: no need to check if customer is split or not in case of 2-opt:
         //       can reverse route parts regardless of this information
-        const SplitInfo& split = sln.route_splits[ri];
 
         // we can only improve routes that have 3+ nodes
-        bool can_improve = route.size() > 2;
+        bool can_improve = size > 2;
         while (can_improve) {
             bool found_new_best = false;
             // skip depots && beware of k = i + 1
-            for (auto i = std::next(route.begin());
-                 !found_new_best && i != std::prev(route.end(), 2); ++i) {
-                size_t customer_i = *i;
-
+            for (size_t i = 1; !found_new_best && i + 2 < size; ++i) {
                 // skip depots && start from i + 1
-                for (auto k = std::next(i);
-                     !found_new_best && k != std::prev(route.end()); ++k) {
-                    size_t customer_k = *k;
-
-                    // cost before: (i-1)->i->(i+1) + (k-1)->k->(k+1)
-                    const auto cost_before = paired_distance_on_route(
-                        m_prob, split, split, m_tw_penalty, i, k);
-                    // perform 2-opt
-                    std::reverse(i, std::next(k));
-                    // cost after: (i-1)->k->(i+1) + (k-1)->i->(k+1)
-                    const auto cost_after = paired_distance_on_route(
-                        m_prob, split, split, m_tw_penalty, i, k);
+                for (size_t k = i + 1; !found_new_best && k + 1 < size; ++k) {
+                    const size_t customer_i = route[i], customer_k = route[k];
+
+                    const TwoOptMove move = {ri, i, k};
+                    const auto cost = evaluate(sln, move);
 
                     // aspiration
                     bool impossible_move =
                         (lists.two_opt.has(customer_k, customer_i) ||
                          lists.pr_two_opt.has(customer_k, customer_i)) &&
-                        cost_after >= best_ever_value;
-
-                    impossible_move |= (!m_can_violate_tw &&
-                                        (constraints::total_violated_time(
-                                             m_prob, split, route.cbegin(),
-                                             route.cend()) != 0));
+                        cost.after >= best_ever_value;
+                    impossible_move |= !cost.feasible();
+                    COUNT_MOVE(TwoOpt, impossible_move, cost);
 
                     // decide whether move is good
-                    if (!impossible_move && cost_after < cost_before) {
+                    if (!impossible_move && cost.after < cost.before) {
                         // move is good
                         found_new_best = true;
+                        apply(sln, move);
                         // forbid previously existing edges
                         lists.two_opt.emplace(customer_i, customer_k);
 #if USE_PRESERVE_ENTRIES
                         lists.pr_two_opt.emplace(customer_k, customer_i);
 #endif
-                        best_ever_value = std::min(best_ever_value, cost_after);
+                        best_ever_value = std::min(best_ever_value, cost.after);
                         improved = true;
-                    } else {
-                        // move is bad - roll back the changes
-                        std::reverse(i, std::next(k));
                     }
                 }
             }
@@ -1187,17 +1677,20 @@ bool LocalSearchMethods::two_opt(Solution& sln, TabuLists& lists,
             can_improve = found_new_best;
         }
     }
-    sln.update_customer_owners(m_prob);
     return improved;
 }
 
 bool LocalSearchMethods::cross(Solution& sln, TabuLists& lists,
                                size_t method_id) {
+    PERF_OPERATOR_TIMER(Cross);
     auto& best_ever_value = m_best_values[method_id];
 
     bool improved = false;
+    sln.update_tw_segments(m_prob);
 
     const auto size = m_prob.n_customers();
+    std::vector<size_t> all_customers(size - 1);
+    std::iota(all_customers.begin(), all_customers.end(), 1);
     for (size_t customer = 1; customer < size; ++customer) {
         bool skip_to_next_customer = false;
         auto cfirst = sln.customer_owners[customer].cbegin(),
@@ -1206,13 +1699,16 @@ bool LocalSearchMethods::cross(Solution& sln, TabuLists& lists,
             size_t r1 = 0, c_index = 0;
             std::tie(r1, c_index) = *cfirst;
             validate_indices(r1, c_index, sln.routes);
-            auto& route1 = sln.routes[r1].second;
+            const auto& route1 = sln.routes[r1].second;
             if (is_loop(route1)) {
                 continue;
             }
-            SplitInfo& split1 = sln.route_splits[r1];
-            size_t neighbour = 1;
-            SAFE_FOR(skip_to_next_customer, neighbour, size) {
+            const SplitInfo& split1 = sln.route_splits[r1];
+            const auto& candidates =
+                neighbours(m_prob, customer, all_customers);
+            auto nbfirst = candidates.cbegin(), nblast = candidates.cend();
+            SAFE_FOR(skip_to_next_customer, nbfirst, nblast) {
+                const size_t neighbour = *nbfirst;
                 if (customer == neighbour) {
                     continue;
                 }
@@ -1228,138 +1724,66 @@ bool LocalSearchMethods::cross(Solution& sln, TabuLists& lists,
                         continue;
                     }
 
-                    auto& route2 = sln.routes[r2].second;
+                    const auto& route2 = sln.routes[r2].second;
                     if (is_loop(route2)) {
                         continue;
                     }
 
-                    SplitInfo& split2 = sln.route_splits[r2];
+                    const SplitInfo& split2 = sln.route_splits[r2];
 
-                    // perform exchange (just swap customer indices)
-                    auto it1 = atit(route1, c_index),
-                         it2 = atit(route2, n_index);
-
-                    std::vector<size_t> customers1(std::next(it1),
-                                                   route1.end());
-                    std::vector<size_t> customers2(std::next(it2),
-                                                   route2.end());
+                    const auto tail1 = atit(route1, c_index + 1),
+                               tail2 = atit(route2, n_index + 1);
 
                     // check if all the customers in a chain can be exchanged
-                    if (!site_dependent(m_prob, sln.routes[r2].first,
-                                        customers1) ||
-                        !site_dependent(m_prob, sln.routes[r1].first,
-                                        customers2)) {
+                    if (!site_dependent(m_prob, sln.routes[r2].first, tail1,
+                                        route1.cend()) ||
+                        !site_dependent(m_prob, sln.routes[r1].first, tail2,
+                                        route2.cend())) {
                         continue;
                     }
 
                     // FIXME: allow such moves?
-                    if (m_enable_splits && split2.has_any(customers1)) {
+                    if (m_enable_splits &&
+                        has_any(split2, tail1, route1.cend())) {
                         continue;
                     }
-                    if (m_enable_splits && split1.has_any(customers2)) {
+                    if (m_enable_splits &&
+                        has_any(split1, tail2, route2.cend())) {
                         continue;
                     }
 
-                    // we assume we can exchange two iterators at this point
-                    size_t customer_next = *std::next(it1),
-                           neighbour_next = *std::next(it2);
-
-                    const auto cost_before =
-                        distance_on_route(m_prob, split1, m_tw_penalty, it1,
-                                          route1.end()) +
-                        distance_on_route(m_prob, split2, m_tw_penalty, it2,
-                                          route2.end());
-
-                    const auto demand1_before =
-                                   total_demand(m_prob, split1, route1.cbegin(),
-                                                route1.cend()),
-                               demand2_before =
-                                   total_demand(m_prob, split2, route2.cbegin(),
-                                                route2.cend());
-
-                    // TODO: optimize
-                    transfer_split_entry(m_enable_splits, split1, split2,
-                                         customers1.cbegin(),
-                                         customers1.cend());
-                    transfer_split_entry(m_enable_splits, split2, split1,
-                                         customers2.cbegin(),
-                                         customers2.cend());
-
-                    cross_routes(route1, std::next(it1), route2,
-                                 std::next(it2));
-
-                    const auto cost_after =
-                        distance_on_route(m_prob, split1, m_tw_penalty, it1,
-                                          route1.end()) +
-                        distance_on_route(m_prob, split2, m_tw_penalty, it2,
-                                          route2.end());
-
-                    const auto demand1_after =
-                                   total_demand(m_prob, split1, route1.cbegin(),
-                                                route1.cend()),
-                               demand2_after =
-                                   total_demand(m_prob, split2, route2.cbegin(),
-                                                route2.cend());
+                    // we assume we can exchange two tails at this point
+                    const size_t customer_next = *tail1,
+                                 neighbour_next = *tail2;
+
+                    const CrossMove move = {r1, c_index, r2, n_index};
+                    const auto cost = evaluate(sln, move);
 
                     // aspiration criteria
                     bool impossible_move =
                         (lists.cross.has(customer, neighbour_next) ||
                          lists.pr_cross.has(customer, customer_next)) &&
-                        cost_after >= best_ever_value;
+                        cost.after >= best_ever_value;
                     impossible_move |=
                         (lists.cross.has(neighbour, customer_next) ||
                          lists.pr_cross.has(neighbour, neighbour_next)) &&
-                        cost_after >= best_ever_value;
-
-                    const auto
-                        route1_capacity =
-                            m_prob.vehicles[sln.routes[r1].first].capacity,
-                        route2_capacity =
-                            m_prob.vehicles[sln.routes[r2].first].capacity;
-
-                    impossible_move |= (demand1_after > route1_capacity &&
-                                        demand1_after > demand1_before);
-                    impossible_move |= (demand2_after > route2_capacity &&
-                                        demand2_after > demand2_before);
-
-                    impossible_move |= (!m_can_violate_tw &&
-                                        (constraints::total_violated_time(
-                                             m_prob, split1, route1.cbegin(),
-                                             route1.cend()) != 0 ||
-                                         constraints::total_violated_time(
-                                             m_prob, split2, route2.cbegin(),
-                                             route2.cend()) != 0));
+                        cost.after >= best_ever_value;
+                    impossible_move |= !cost.feasible();
+                    COUNT_MOVE(Cross, impossible_move, cost);
 
                     // decide whether move is good
-                    if (!impossible_move && cost_after < cost_before) {
+                    if (!impossible_move && cost.after < cost.before) {
                         // move is good
-                        for (size_t c1 : customers1) {
-                            sln.customer_owners[c1].erase(r1);
-                        }
-                        for (size_t c2 : customers2) {
-                            sln.customer_owners[c2].erase(r2);
-                        }
-                        sln.update_customer_owners(m_prob, r1, c_index);
-                        sln.update_customer_owners(m_prob, r2, n_index);
+                        apply(sln, move);
                         lists.cross.emplace(customer, customer_next);
                         lists.cross.emplace(neighbour, neighbour_next);
 #if USE_PRESERVE_ENTRIES
                         lists.pr_cross.emplace(customer, neighbour_next);
                         lists.pr_cross.emplace(neighbour, customer_next);
 #endif
-                        best_ever_value = std::min(best_ever_value, cost_after);
+                        best_ever_value = std::min(best_ever_value, cost.after);
                         improved = true;
                         skip_to_next_customer = true;
-                    } else {
-                        // move is bad - roll back the changes
-                        transfer_split_entry(m_enable_splits, split2, split1,
-                                             customers1.cbegin(),
-                                             customers1.cend());
-                        transfer_split_entry(m_enable_splits, split1, split2,
-                                             customers2.cbegin(),
-                                             customers2.cend());
-                        cross_routes(route1, std::next(it1), route2,
-                                     std::next(it2));
                     }
                 }
             }
@@ -1375,9 +1799,7 @@ std::string LocalSearchMethods::str(size_t i) const {
 }
 
 void LocalSearchMethods::route_save(Solution& sln, size_t threshold) {
-    // _must_ relocate all customers, otherwise do not relocate anyone
-    auto sln_copy = sln;
-
+    PERF_OPERATOR_TIMER(RouteSave);
     std::list<size_t> small_routes;
     for (size_t ri = 0; ri < sln.routes.size(); ++ri) {
         auto& route = sln.routes[ri].second;
@@ -1390,11 +1812,18 @@ void LocalSearchMethods::route_save(Solution& sln, size_t threshold) {
         return sln.routes[i].second.size() < sln.routes[j].second.size();
     });
 
+    sln.update_tw_segments(m_prob);
+
+    // _must_ relocate all customers, otherwise do not relocate anyone: moves
+    // are journaled until route is emptied
+    SolutionJournal journal;
+    journal.begin(sln);
+
     const auto size = m_prob.n_customers();
     while (!small_routes.empty()) {
         auto r_in = small_routes.front();
         small_routes.pop_front();
-        auto& route_in = sln.routes[r_in].second;
+        const auto& route_in = sln.routes[r_in].second;
         // check if current route (where customer was relocated) is still
         // small. if not anymore, skip
         if (route_in.size() > threshold) {
@@ -1404,10 +1833,10 @@ void LocalSearchMethods::route_save(Solution& sln, size_t threshold) {
         const size_t max_iters = route_in.size();
         for (size_t iter = 0; iter < max_iters && !is_loop(route_in); ++iter) {
             size_t customer = *std::next(route_in.cbegin());
-            size_t c_index = sln.customer_owners[customer][r_in];
+            size_t c_index = sln.customer_owners.at(customer, r_in);
             validate_indices(r_in, c_index, sln.routes);
 
-            SplitInfo& split_in = sln.route_splits[r_in];
+            const SplitInfo& split_in = sln.route_splits[r_in];
 
             bool skip_to_next_iter = false;
             for (size_t neighbour = 1; !skip_to_next_iter && neighbour < size;
@@ -1427,7 +1856,7 @@ void LocalSearchMethods::route_save(Solution& sln, size_t threshold) {
                         continue;
                     }
 
-                    auto& route_out = sln.routes[r_out].second;
+                    const auto& route_out = sln.routes[r_out].second;
                     if (is_loop(route_out)) {
                         continue;
                     }
@@ -1437,7 +1866,7 @@ void LocalSearchMethods::route_save(Solution& sln, size_t threshold) {
                         continue;
                     }
 
-                    SplitInfo& split_out = sln.route_splits[r_out];
+                    const SplitInfo& split_out = sln.route_splits[r_out];
                     // do not relocate to the route where customer already
                     // exists
                     if (m_enable_splits && split_out.has(customer)) {
@@ -1447,17 +1876,18 @@ void LocalSearchMethods::route_save(Solution& sln, size_t threshold) {
                     // customer value represents the length of route i -> j,
                     // where:
                     // ... -> (i -> customer -> j) -> ...
-                    const auto customer_value =
-                        distance_on_route(m_prob, split_in, 0, route_in,
-                                          c_index - 1, c_index + 2);
+                    const auto& costs_out = route_costs(m_prob, sln, r_out);
+                    const auto customer_value = distance_on_route(
+                        m_prob, route_costs(m_prob, sln, r_in), split_in, 0,
+                        route_in, c_index - 1, c_index + 2);
                     const auto customer_neighbour_distance =
-                        m_prob.costs[customer][neighbour];
+                        costs_out(customer, neighbour);
                     const auto customer_before_neighbour_value =
                         customer_neighbour_distance +
-                        m_prob.costs[customer][at(route_out, n_index - 1)];
+                        costs_out(customer, route_out.at(n_index - 1));
                     const auto customer_after_neighbour_value =
                         customer_neighbour_distance +
-                        m_prob.costs[customer][at(route_out, n_index + 1)];
+                        costs_out(customer, route_out.at(n_index + 1));
 
                     // if customer is closer to it's neighbours in
                     // __current__ route, do not relocate to neighbours in
@@ -1469,126 +1899,71 @@ void LocalSearchMethods::route_save(Solution& sln, size_t threshold) {
 
                     // we assume there's a better place for our customer at
                     // this point
-
-                    auto it_in_before = atit(route_in, c_index - 1),
-                         it_in_after = atit(route_in, c_index + 1),
-                         it_out_before = atit(route_out, n_index - 1),
-                         it_out_after = atit(route_out, n_index + 1);
-
-                    const auto cost_before =
-                        distance_on_route(m_prob, split_in, m_tw_penalty,
-                                          it_in_before,
-                                          std::next(it_in_after)) +
-                        distance_on_route(m_prob, split_out, m_tw_penalty,
-                                          it_out_before,
-                                          std::next(it_out_after));
-
-                    Solution::RouteType::iterator inserted, erased;
-                    if (customer_before_neighbour_value <
-                        customer_after_neighbour_value) {
-                        inserted = route_out.insert(std::next(it_out_before),
-                                                    customer);
-                    } else {
-                        inserted = route_out.insert(it_out_after, customer);
-                    }
-
-                    transfer_split_entry(m_enable_splits, split_in, split_out,
-                                         customer);
-
-                    erased = route_in.erase(std::next(it_in_before));
-
-                    const auto cost_after =
-                        distance_on_route(m_prob, split_in, m_tw_penalty,
-                                          it_in_before,
-                                          std::next(it_in_after)) +
-                        distance_on_route(m_prob, split_out, m_tw_penalty,
-                                          it_out_before,
-                                          std::next(it_out_after));
-
-                    const auto out_demand_after =
-                        total_demand(m_prob, split_out, route_out.cbegin(),
-                                     route_out.cend());
-
-                    const auto out_capacity =
-                        m_prob.vehicles[sln.routes[r_out].first].capacity;
-                    bool impossible_move = (out_demand_after > out_capacity);
-                    impossible_move |=
-                        (!m_can_violate_tw &&
-                         (constraints::total_violated_time(
-                              m_prob, split_in, route_in.cbegin(),
-                              route_in.cend()) != 0 ||
-                          constraints::total_violated_time(
-                              m_prob, split_out, route_out.cbegin(),
-                              route_out.cend()) != 0));
+                    const size_t insert_index =
+                        customer_before_neighbour_value <
+                                customer_after_neighbour_value
+                            ? n_index
+                            : n_index + 1;
+                    const RelocateMove move = {customer, r_in,    c_index,
+                                               r_out,    n_index, insert_index};
+                    const auto cost = evaluate(sln, move);
+                    COUNT_MOVE(RouteSave, false, cost);
 
                     // decide whether move is good
-                    if (!impossible_move && cost_after < cost_before) {
+                    if (cost.feasible() && cost.after < cost.before) {
                         // move is good
-                        sln.customer_owners[customer].erase(r_in);
-                        sln.update_customer_owners(m_prob, r_in, c_index);
-                        sln.update_customer_owners(m_prob, r_out, n_index - 1);
+                        journal.record_route(sln, r_in);
+                        journal.record_route(sln, r_out);
+                        apply(sln, move);
                         skip_to_next_iter = true;
-                    } else {
-                        // move is bad - roll back the changes
-                        route_in.insert(erased, customer);
-                        route_out.erase(inserted);
-                        transfer_split_entry(m_enable_splits, split_out,
-                                             split_in, customer);
                     }
                 }
             }
         }
 
-        // get more recent copy of solution if route is emptied
+        // keep moves if route is emptied
         if (is_loop(route_in)) {
-            sln_copy = sln;
+            journal.commit();
+            journal.begin(sln);
         }
     }
-    sln = std::move(sln_copy);
+    journal.rollback(sln);
     delete_loops_after_relocate(sln);
-    sln.update_customer_owners(m_prob);
 }
 
 void LocalSearchMethods::intra_relocate(Solution& sln) {
+    PERF_OPERATOR_TIMER(IntraRelocate);
+    sln.update_tw_segments(m_prob);
     for (size_t ri = 0; ri < sln.routes.size(); ++ri) {
-        auto& route = sln.routes[ri].second;
+        const size_t size = sln.routes[ri].second.size();
 
-        // Note: no need to check if customer is split or not in case of 2-opt:
-        //       can reverse route parts regardless of this information
-        const SplitInfo& split = sln.route_splits[ri];
+        // Note: no need to check if customer is split or not in case of
+        //       intra-route swap: split info does not depend on positions
 
-        for (auto pos = std::next(route.begin()); pos != std::prev(route.end());
-             ++pos) {
-            for (auto new_pos = std::next(route.begin());
-                 new_pos != std::prev(route.end()); ++new_pos) {
+        // skip depots
+        for (size_t pos = 1; pos + 1 < size; ++pos) {
+            for (size_t new_pos = 1; new_pos + 1 < size; ++new_pos) {
                 if (pos == new_pos) {
                     continue;
                 }
 
-                const auto cost_before = distance_on_route(
-                    m_prob, split, m_tw_penalty, route.begin(), route.end());
                 // move customer to new position
-                std::swap(*pos, *new_pos);
-                const auto cost_after = distance_on_route(
-                    m_prob, split, m_tw_penalty, route.begin(), route.end());
-
-                const bool impossible_move =
-                    (!m_can_violate_tw &&
-                     (constraints::total_violated_time(
-                          m_prob, split, route.cbegin(), route.cend()) != 0));
+                const IntraSwapMove move = {ri, std::min(pos, new_pos),
+                                            std::max(pos, new_pos)};
+                const auto cost = evaluate(sln, move);
+                COUNT_MOVE(IntraRelocate, false, cost);
 
                 // decide whether move is good
-                if (!impossible_move && cost_after >= cost_before) {
-                    // move is bad - roll back the changes
-                    std::swap(*pos, *new_pos);
+                if (cost.feasible() && cost.after < cost.before) {
+                    apply(sln, move);
                 }
             }
         }
     }
-    sln.update_customer_owners(m_prob);
 }
 
 void LocalSearchMethods::merge_splits(Solution& sln) {
+    PERF_OPERATOR_TIMER(MergeSplits);
     if (!m_prob.enable_splits()) {
         return;
     }
@@ -1598,12 +1973,14 @@ void LocalSearchMethods::merge_splits(Solution& sln) {
         const auto& route_split = sln.route_splits[ri].split_info;
         for (const auto& p : route_split) {
             // only store split customers
-            if (p.second > 0.0 && p.second < 1.0) {
+            if (p.second.ratio.partial()) {
                 split_customers.emplace(p.first);
             }
         }
     }
 
+    sln.update_tw_segments(m_prob);
+
     // "relocate" split customer to another route where this customer already
     // exists
     for (size_t customer : split_customers) {
@@ -1614,11 +1991,9 @@ void LocalSearchMethods::merge_splits(Solution& sln) {
             size_t r_in = 0, c_in = 0;
             std::tie(r_in, c_in) = *cfirst1;
             validate_indices(r_in, c_in, sln.routes);
-            auto& route_in = sln.routes[r_in].second;
-            if (is_loop(route_in)) {
+            if (is_loop(sln.routes[r_in].second)) {
                 continue;
             }
-            SplitInfo& split_in = sln.route_splits[r_in];
 
             auto cfirst2 = sln.customer_owners[customer].cbegin();
             SAFE_FOR(skip_to_next_customer, cfirst2, clast) {
@@ -1628,67 +2003,26 @@ void LocalSearchMethods::merge_splits(Solution& sln) {
                 size_t r_out = 0, c_out = 0;
                 std::tie(r_out, c_out) = *cfirst2;
                 validate_indices(r_out, c_out, sln.routes);
-                auto& route_out = sln.routes[r_out].second;
-                if (is_loop(route_out)) {
+                if (is_loop(sln.routes[r_out].second)) {
                     continue;
                 }
 
-                SplitInfo& split_out = sln.route_splits[r_out];
-
-                auto it_in_before = atit(route_in, c_in - 1),
-                     it_in_after = atit(route_in, c_in + 1),
-                     it_out_before = atit(route_out, c_out - 1),
-                     it_out_after = atit(route_out, c_out + 1);
-
-                const auto cost_before =
-                    distance_on_route(m_prob, split_in, m_tw_penalty,
-                                      it_in_before, std::next(it_in_after)) +
-                    distance_on_route(m_prob, split_out, m_tw_penalty,
-                                      it_out_before, std::next(it_out_after));
-
-                auto erased_ratio = split_in.at(customer);
-                split_in.split_info.erase(customer);
-                split_out.split_info.at(customer) += erased_ratio;
-
-                auto erased = route_in.erase(std::next(it_in_before));
-
-                const auto cost_after =
-                    distance_on_route(m_prob, split_in, m_tw_penalty,
-                                      it_in_before, std::next(it_in_after)) +
-                    distance_on_route(m_prob, split_out, m_tw_penalty,
-                                      it_out_before, std::next(it_out_after));
-
-                const auto out_demand_after = total_demand(
-                    m_prob, split_out, route_out.cbegin(), route_out.cend());
-
-                const auto out_capacity =
-                    m_prob.vehicles[sln.routes[r_out].first].capacity;
-                bool impossible_move = (out_demand_after > out_capacity);
-
-                impossible_move |= (!m_can_violate_tw &&
-                                    (constraints::total_violated_time(
-                                         m_prob, split_out, route_out.cbegin(),
-                                         route_out.cend()) != 0));
+                const MergeSplitMove move = {customer, r_in, c_in, r_out,
+                                             c_out};
+                const auto cost = evaluate(sln, move);
+                COUNT_MOVE(MergeSplits, false, cost);
 
                 // decide whether move is good
-                if (!impossible_move && cost_after < cost_before) {
+                if (cost.feasible() && cost.after < cost.before) {
                     // move is good
-                    sln.customer_owners[customer].erase(r_in);
-                    sln.update_customer_owners(m_prob, r_in, c_in);
+                    apply(sln, move);
                     skip_to_next_customer = true;
-                } else {
-                    // move is bad - roll back the changes
-                    split_in.split_info[customer] = erased_ratio;
-                    split_out.split_info.at(customer) -= erased_ratio;
-                    route_in.insert(erased, customer);
                 }
             }
         }
     }
     delete_loops_after_relocate(sln);
-    sln.update_customer_owners(m_prob);
 }
-
 void LocalSearchMethods::penalize_tw(double value) { m_tw_penalty = value; }
 void LocalSearchMethods::violate_tw(bool value) { m_can_violate_tw = value; }
 }  // namespace tabu
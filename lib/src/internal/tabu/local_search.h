@@ -1,5 +1,6 @@
 #pragma once
 
+#include "moves.h"
 #include "solution.h"
 #include "tabu_lists.h"
 
@@ -35,6 +36,26 @@ class LocalSearchMethods {
     bool relocate_new_route(Solution& sln, TabuLists& lists, size_t method_id);
     bool relocate_split(Solution& sln, TabuLists& lists, size_t method_id);
 
+    // move evaluation: cost and feasibility of a move computed without
+    // modifying the solution. expects up to date time window segments
+    MoveCost evaluate(const Solution& sln, const RelocateMove& move) const;
+    MoveCost evaluate(const Solution& sln, const NewRouteMove& move) const;
+    MoveCost evaluate(const Solution& sln, const ExchangeMove& move) const;
+    MoveCost evaluate(const Solution& sln, const TwoOptMove& move) const;
+    MoveCost evaluate(const Solution& sln, const CrossMove& move) const;
+    MoveCost evaluate(const Solution& sln, const IntraSwapMove& move) const;
+    MoveCost evaluate(const Solution& sln, const MergeSplitMove& move) const;
+
+    // move application: modifies the solution keeping customer owners and
+    // time window segments of affected routes up to date
+    void apply(Solution& sln, const RelocateMove& move) const;
+    void apply(Solution& sln, const NewRouteMove& move) const;
+    void apply(Solution& sln, const ExchangeMove& move) const;
+    void apply(Solution& sln, const TwoOptMove& move) const;
+    void apply(Solution& sln, const CrossMove& move) const;
+    void apply(Solution& sln, const IntraSwapMove& move) const;
+    void apply(Solution& sln, const MergeSplitMove& move) const;
+
 public:
     LocalSearchMethods() = delete;
     LocalSearchMethods(const Problem& prob) noexcept;
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+
+namespace vrp {
+namespace tabu {
+/// Relocate customer from one route to another
+struct RelocateMove {
+    size_t customer = 0;
+    size_t r_in = 0;          ///< route customer is taken from
+    size_t c_index = 0;       ///< customer position in r_in
+    size_t r_out = 0;         ///< route customer is inserted into
+    size_t n_index = 0;       ///< position of r_out neighbour customer is
+                              ///< inserted next to
+    size_t insert_index = 0;  ///< customer position in r_out after the move:
+                              ///< n_index or n_index + 1
+};
+
+/// Relocate customer from its route to a new route
+struct NewRouteMove {
+    size_t customer = 0;
+    size_t r_in = 0;     ///< route customer is taken from
+    size_t c_index = 0;  ///< customer position in r_in
+    size_t vehicle = 0;  ///< vehicle serving the new route
+};
+
+/// Exchange customers of two different routes
+struct ExchangeMove {
+    size_t r1 = 0;
+    size_t c_index = 0;  ///< customer position in r1
+    size_t r2 = 0;
+    size_t n_index = 0;  ///< neighbour position in r2
+};
+
+/// Reverse route positions [first, last]
+struct TwoOptMove {
+    size_t route = 0;
+    size_t first = 0;
+    size_t last = 0;
+};
+
+/// Swap tails of two different routes: r1 after c_index <-> r2 after n_index
+struct CrossMove {
+    size_t r1 = 0;
+    size_t c_index = 0;
+    size_t r2 = 0;
+    size_t n_index = 0;
+};
+
+/// Swap two customers of the same route
+struct IntraSwapMove {
+    size_t route = 0;
+    size_t first = 0;   ///< smaller position
+    size_t second = 0;  ///< greater position
+};
+
+/// Merge split customer part from r_in into the part served by r_out
+struct MergeSplitMove {
+    size_t customer = 0;
+    size_t r_in = 0;
+    size_t c_in = 0;  ///< customer position in r_in
+    size_t r_out = 0;
+    size_t c_out = 0;  ///< customer position in r_out
+};
+
+/// Move evaluation result. Costs cover only the route parts the move affects
+struct MoveCost {
+    double before = 0.0;  ///< cost of affected route parts before the move
+    double after = 0.0;   ///< cost of affected route parts after the move
+    bool satisfies_capacity = true;      ///< capacity is not violated
+    bool satisfies_time_windows = true;  ///< time windows are not violated
+                                         ///< or can be violated
+
+    inline bool feasible() const noexcept {
+        return satisfies_capacity && satisfies_time_windows;
+    }
+};
+}  // namespace tabu
+}  // namespace vrp
@@ -1,13 +1,7 @@
 #pragma once
 
 #include <algorithm>
-#include <cstdint>
-#include <functional>
-#include <iterator>
-#include <set>
-#include <stack>
-#include <type_traits>
-#include <unordered_set>
+#include <cstddef>
 #include <utility>
 #include <vector>
 
@@ -19,59 +13,58 @@
 
 namespace vrp {
 namespace tabu {
-#define USE_HASH_SET 1
-
-namespace detail {
-template<typename T, int Tenure> struct Entry : public T {
-    // T value;
-    int count = Tenure;
-
-    Entry() = delete;
-    inline Entry(const T& v) : T(v) {}
-    inline Entry(T&& v) : T(std::move(v)) {}
-};
-
-#if USE_HASH_SET
-template<typename U, int Tenure = 0> struct Hash {};
+/// Tabu list of (first, second) index pairs, e.g. (customer, route) or
+/// (customer, customer). Each entry holds an "expires at" stamp in a matrix
+/// indexed by the pair, so lookups, insertions and ageing are O(1). The
+/// matrix grows on demand and is never shrunk
+template<int Tenure> class TabuList {
+    std::vector<int> m_expiry = {};  ///< expiry stamps, row-major. entry
+                                     ///< exists while stamp > m_now
+    size_t m_rows = 0;               ///< number of first indices
+    size_t m_cols = 0;               ///< number of second indices
+    int m_now = 0;                   ///< current stamp, advanced by ageing
+
+    inline size_t index(size_t first, size_t second) const noexcept {
+        return first * m_cols + second;
+    }
 
-template<int Tenure> struct Hash<std::pair<size_t, size_t>, Tenure> {
-    inline size_t
-    operator()(const Entry<std::pair<size_t, size_t>, Tenure>& e) const
-        noexcept {
-        return (e.first << 16) ^ e.second;
+    inline int remaining(size_t first, size_t second) const noexcept {
+        if (first >= m_rows || second >= m_cols) {
+            return 0;
+        }
+        return m_expiry[index(first, second)] - m_now;
     }
-};
 
-template<int Tenure> struct Hash<size_t, Tenure> {
-    inline size_t operator()(const Entry<size_t, Tenure>& e) const noexcept {
-        return e;
+    void grow(size_t rows, size_t cols) {
+        if (rows <= m_rows && cols <= m_cols) {
+            return;
+        }
+        // grow geometrically as indices usually increase one by one
+        const size_t new_rows = std::max(m_rows, std::max(rows, 2 * m_rows));
+        const size_t new_cols = std::max(m_cols, std::max(cols, 2 * m_cols));
+        std::vector<int> expiry(new_rows * new_cols, 0);
+        for (size_t r = 0; r < m_rows; ++r) {
+            std::copy_n(m_expiry.cbegin() + r * m_cols, m_cols,
+                        expiry.begin() + r * new_cols);
+        }
+        m_expiry = std::move(expiry);
+        m_rows = new_rows;
+        m_cols = new_cols;
     }
-};
-#endif
-}  // namespace detail
-
-template<typename T, int Tenure> class TabuList {
-#if USE_HASH_SET
-    using set_t =
-        std::unordered_set<detail::Entry<T, Tenure>, detail::Hash<T, Tenure>>;
-#else
-    using set_t = std::set<detail::Entry<T, Tenure>>;
-#endif
-    using vector_t = std::vector<detail::Entry<T, Tenure>>;
-    set_t entries;
-
-    inline set_t diff(const set_t& lhs, const set_t& rhs) {
-#define MOVE(x) std::make_move_iterator(x)
-        set_t result;
-        vector_t vrhs(rhs.cbegin(), rhs.cend());
-        std::sort(vrhs.begin(), vrhs.end());
-        vector_t vlhs(lhs.cbegin(), lhs.cend());
-        std::sort(vlhs.begin(), vlhs.end());
-        std::set_difference(MOVE(vrhs.begin()), MOVE(vrhs.end()),
-                            MOVE(vlhs.begin()), MOVE(vlhs.end()),
-                            std::inserter(result, result.end()));
-#undef MOVE
-        return result;
+
+    void merge(const TabuList& other) {
+        // only add entries that do not exist in tabu list, keeping their
+        // remaining tenure
+        grow(other.m_rows, other.m_cols);
+        for (size_t r = 0; r < other.m_rows; ++r) {
+            for (size_t c = 0; c < other.m_cols; ++c) {
+                const int left = other.remaining(r, c);
+                int& expiry = m_expiry[index(r, c)];
+                if (left > 0 && expiry <= m_now) {
+                    expiry = m_now + left;
+                }
+            }
+        }
     }
 
 public:
@@ -80,51 +73,53 @@ public:
     TabuList(const TabuList& other) = default;
     TabuList(TabuList&& other) = default;
     TabuList& operator=(const TabuList& other) {
-        // only add entries that do not exist in tabu list
-        auto new_entries = diff(entries, other.entries);
-        std::copy(std::make_move_iterator(new_entries.begin()),
-                  std::make_move_iterator(new_entries.end()),
-                  std::inserter(entries, entries.end()));
+        merge(other);
         return *this;
     }
     TabuList& operator=(TabuList&& other) {
-        // only add entries that do not exist in tabu list
-        auto new_entries = diff(entries, other.entries);
-        std::copy(std::make_move_iterator(new_entries.begin()),
-                  std::make_move_iterator(new_entries.end()),
-                  std::inserter(entries, entries.end()));
+        merge(other);
         return *this;
     }
 
-    inline void decrement() {
-        // decrement all, erase expired tabu entries
-        set_t non_expired_entries = {};
-        for (auto entry : entries) {
-            entry.count--;
-            if (entry.count > 0) {
-                non_expired_entries.emplace(entry);
-            }
-        }
-        entries = std::move(non_expired_entries);
-    }
+    /// age all entries by one iteration: entries with expired tenure vanish
+    inline void decrement() { ++m_now; }
 
-    inline void clear() { entries.clear(); }
+    inline void clear() {
+        std::fill(m_expiry.begin(), m_expiry.end(), 0);
+        m_now = 0;
+    }
 
-    template<typename... Args> void emplace(Args&&... args) {
-        entries.emplace(T(std::forward<Args>(args)...));
+    /// add entry. existing entry keeps its remaining tenure
+    inline void emplace(size_t first, size_t second) {
+        grow(first + 1, second + 1);
+        int& expiry = m_expiry[index(first, second)];
+        if (expiry <= m_now) {
+            expiry = m_now + Tenure;
+        }
     }
 
-    template<typename... Args> bool has(Args&&... args) {
-        return std::find(entries.cbegin(), entries.cend(),
-                         T(std::forward<Args>(args)...)) != entries.cend();
+    inline bool has(size_t first, size_t second) const noexcept {
+        return remaining(first, second) > 0;
     }
 
-    set_t& all() { return entries; }
-    const set_t& all() const { return entries; }
-};  // namespace tabu
+    /// erase entries which second index equals column, shift entries which
+    /// second index is in (column, size) one position left. used when a
+    /// route is deleted from a solution of size routes
+    void erase_column(size_t column, size_t size) {
+        const size_t last = std::min(size, m_cols);
+        if (column >= last) {
+            return;
+        }
+        for (size_t r = 0; r < m_rows; ++r) {
+            const auto row = m_expiry.begin() + r * m_cols;
+            std::copy(row + column + 1, row + last, row + column);
+            row[last - 1] = 0;
+        }
+    }
+};
 
 class TabuLists {
-    using tabu_list_t = TabuList<std::pair<size_t, size_t>, TABU_TENURE>;
+    using tabu_list_t = TabuList<TABU_TENURE>;
     using preserve_list_t = tabu_list_t;
 
 public:
@@ -187,6 +182,5 @@ public:
     }
 };
 
-#undef USE_HASH_SET
 }  // namespace tabu
 }  // namespace vrp
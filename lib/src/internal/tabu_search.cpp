@@ -3,7 +3,9 @@
 #include "logging.h"
 #include "objective.h"
 #include "threading.h"
+#include "time_budget.h"
 
+#include "src/internal/counters.h"
 #include "src/internal/tabu/local_search.h"
 #include "src/internal/tabu/tabu_lists.h"
 
@@ -11,6 +13,7 @@
 #include <cmath>
 #include <stdexcept>
 #include <unordered_map>
+#include <utility>
 
 namespace vrp {
 namespace detail {
@@ -33,6 +36,11 @@ constexpr const uint32_t CONSTRAINTS_FIX_ITERS = 0.1 * TABU_SEARCH_ITERS;
 
 constexpr const uint32_t MAX_VIOLATION_ITERS = 3;
 
+// a run is stopped when its best objective exceeds shared incumbent by this
+// ratio, but not before it makes the minimum number of iterations
+constexpr const double INCUMBENT_GAP = 0.25;
+constexpr const uint32_t INCUMBENT_MIN_ITERS = TABU_SEARCH_ITERS;
+
 void update_tabu_lists(tabu::TabuLists& lists, const tabu::TabuLists& new_lists,
                        size_t i) {
     switch (i) {
@@ -74,49 +82,70 @@ uint32_t threshold(const Problem& prob) {
     return std::max(1u, static_cast<uint32_t>(prob.n_customers() * 0.05)) + 2u;
 }
 
-inline void do_local_search(const tabu::LocalSearchMethods& ls,
-                            std::vector<Solution>& slns, tabu::TabuLists& lists,
-                            std::vector<bool>& was_improved) {
-    assert(slns.size() == ls.size());
+/// Outcome of local search methods applied to the same solution. Solutions
+/// are reused between iterations: assigning into them keeps the storage of
+/// routes and hash tables that is already allocated
+struct LocalSearchResults {
+    Solution scratch;                  ///< solution a method is applied to
+    Solution best;                     ///< best produced solution
+    double best_value = 0.0;           ///< objective of best solution
+    size_t best_method = 0;            ///< method that produced best solution
+    Solution best_feasible;            ///< best produced feasible solution
+    double best_feasible_value = 0.0;  ///< objective of best feasible solution
+    size_t n_feasible = 0;             ///< number of feasible solutions
+};
+
+/// apply each local search method to a copy of sln, keeping only the best
+/// outcomes. first method's solution is always a candidate, others are
+/// candidates if improved or if only_improved is false
+inline void do_local_search(const Problem& prob,
+                            const tabu::LocalSearchMethods& ls,
+                            const Solution& sln, tabu::TabuLists& lists,
+                            std::vector<bool>& was_improved, bool only_improved,
+                            LocalSearchResults& results) {
+    assert(was_improved.size() == ls.size());
+    results.n_feasible = 0;
+    auto& scratch = results.scratch;
     for (size_t m = 0, size = ls.size(); m != size; ++m) {
-        was_improved[m] = ls[m](slns[m], lists);
-    }
-}
+        // first method's solution is always a candidate, others are skipped
+        // once time budget expires
+        if (m != 0 && time_budget::expired()) {
+            break;
+        }
+        scratch = sln;
+        was_improved[m] = ls[m](scratch, lists);
+        const double value = objective(prob, scratch);
+
+        // TODO: check if this is required. doesn't seem like it's working
+        // Note: feasible solution is checked against improvement flag of its
+        //       rank among feasible solutions, not of its method
+        if (constraints::satisfies_all(prob, scratch)) {
+            const size_t rank = results.n_feasible++;
+            if (rank == 0 || (was_improved[rank] &&
+                              value < results.best_feasible_value)) {
+                results.best_feasible = scratch;
+                results.best_feasible_value = value;
+            }
+        }
 
-inline std::vector<Solution> repeat(const Solution& sln, size_t times) {
-    std::vector<Solution> slns(times);
-    for (auto& s : slns) {
-        s = sln;
+        if (m == 0 || ((!only_improved || was_improved[m]) &&
+                       value < results.best_value)) {
+            std::swap(results.best, scratch);
+            results.best_value = value;
+            results.best_method = m;
+        }
     }
-    return slns;
 }
 }  // namespace
 
-Solution tabu_search(const Problem& prob, const Solution& initial_sln) {
+Solution tabu_search(const Problem& prob, const Solution& initial_sln,
+                     SharedIncumbent* incumbent) {
     // capture-by-ref is guaranteed to work because Problem class doesn't change
     // at this point throughout the whole application run
-    thread_local const auto less = [&prob](const auto& a, const auto& b) {
+    const auto less = [&prob](const auto& a, const auto& b) {
         return objective(prob, a) < objective(prob, b);
     };
 
-    // find min element in improved solutions
-    thread_local const auto min_element = [](const std::vector<Solution>& slns,
-                                             const std::vector<bool>& impr) {
-        if (slns.empty()) {
-            return slns.cend();
-        }
-        auto min = slns.cbegin();
-        for (auto first = slns.cbegin() + 1; first != slns.cend(); ++first) {
-            if (!impr[std::distance(slns.cbegin(), first)]) {
-                continue;
-            }
-            if (less(*first, *min)) {
-                min = first;
-            }
-        }
-        return min;
-    };
-
     const auto route_saving_threshold = threshold(prob);
 
     tabu::LocalSearchMethods ls(prob);
@@ -134,7 +163,8 @@ Solution tabu_search(const Problem& prob, const Solution& initial_sln) {
 
     const auto sqr_objective_baseline = std::pow(objective(prob, best_sln), 2);
 
-    std::vector<Solution> slns = repeat(best_sln, ls.size());
+    Solution curr_sln = best_sln;
+    LocalSearchResults results;
     std::vector<bool> was_improved(ls.size(), false);
     tabu::TabuLists lists{};
 
@@ -151,6 +181,11 @@ Solution tabu_search(const Problem& prob, const Solution& initial_sln) {
     // ci - constant iterations counter, always counts forward
     for (uint32_t i = 0, ci = 0; i < TABU_SEARCH_ITERS && ci < MAX_ITERS;
          ++i, ++ci) {
+        // time budget expired: keep best solutions found so far
+        if (time_budget::expired()) {
+            break;
+        }
+        PERF_ITERATION_TIMER();
 
         if (ci == 0 || constraints_count < CONSTRAINTS_FIX_ITERS * 0.9) {
             ls.penalize_tw(
@@ -179,27 +214,14 @@ Solution tabu_search(const Problem& prob, const Solution& initial_sln) {
 #endif
 
         auto updated_lists = lists;
-        do_local_search(ls, slns, updated_lists, was_improved);
-
-        auto min_sln_it = min_element(slns, was_improved);
-
-        // TODO: check if this is required. doesn't seem like it's working
-        std::vector<Solution> feasible_slns;
-        feasible_slns.reserve(slns.size());
-        for (const auto& sln : slns) {
-            if (!constraints::satisfies_all(prob, sln)) {
-                continue;
-            }
-            feasible_slns.emplace_back(sln);
-        }
-        auto min_feasible_sln_it = min_element(feasible_slns, was_improved);
+        do_local_search(prob, ls, curr_sln, updated_lists, was_improved, true,
+                        results);
 
         --lists;
 
-        update_tabu_lists(lists, updated_lists,
-                          std::distance(slns.cbegin(), min_sln_it));
+        update_tabu_lists(lists, updated_lists, results.best_method);
 
-        auto curr_sln = *min_sln_it;
+        std::swap(curr_sln, results.best);
 
         // penalize for time windows violation
         if (!constraints::satisfies_time_windows(prob, curr_sln)) {
@@ -209,18 +231,27 @@ Solution tabu_search(const Problem& prob, const Solution& initial_sln) {
         }
 
         // found new best: reset best solution, reset iter counter to 0
-        if (objective(prob, curr_sln) < objective(prob, best_sln)) {
+        if (results.best_value < objective(prob, best_sln)) {
             best_sln = curr_sln;
             i = 0;
         }
 
         // found new feasible best: reset best feasible, reset iter counter to 0
-        if (min_feasible_sln_it != feasible_slns.cend() &&
-            (objective(prob, *min_feasible_sln_it) <
-                 objective(prob, best_feasible_sln) ||
+        if (results.n_feasible != 0 &&
+            (results.best_feasible_value < objective(prob, best_feasible_sln) ||
              !constraints::satisfies_all(prob, best_feasible_sln))) {
-            best_feasible_sln = *min_feasible_sln_it;
+            best_feasible_sln = results.best_feasible;
             i = 0;
+            if (incumbent) {
+                incumbent->update(results.best_feasible_value);
+            }
+        }
+
+        // stop if hopelessly behind other runs
+        if (incumbent && ci >= INCUMBENT_MIN_ITERS &&
+            objective(prob, best_sln) >
+                (1.0 + INCUMBENT_GAP) * incumbent->value()) {
+            break;
         }
 
         const bool perform_route_saving = ci % ROUTE_SAVING_ITERS == 0;
@@ -240,23 +271,21 @@ Solution tabu_search(const Problem& prob, const Solution& initial_sln) {
 #if DYNAMIC_VIOLATIONS
         curr_sln_feasible = constraints::satisfies_all(prob, curr_sln);
 #endif
-
-        slns = repeat(curr_sln, ls.size());
     }
 
-    thread_local const auto do_post_optimization = [&](Solution& best_sln) {
+    const auto do_post_optimization = [&](Solution& best_sln) {
         // post-optimization phase. drastically penalize for TW violation
         ls.penalize_tw(sqr_objective_baseline);
 
         auto curr_sln = best_sln;
 
-        for (size_t i = 0; i < 2; ++i) {
+        for (size_t i = 0; i < 2 && !time_budget::expired(); ++i) {
             lists = tabu::TabuLists();
-            slns = repeat(curr_sln, ls.size());
             // no tabu is required now
-            do_local_search(ls, slns, lists, was_improved);
+            do_local_search(prob, ls, curr_sln, lists, was_improved, false,
+                            results);
 
-            curr_sln = *std::min_element(slns.cbegin(), slns.cend(), less);
+            std::swap(curr_sln, results.best);
 
             // TODO: add US heuristic as well
             ls.intra_relocate(curr_sln);
@@ -272,6 +301,10 @@ Solution tabu_search(const Problem& prob, const Solution& initial_sln) {
     do_post_optimization(best_sln);
     do_post_optimization(best_feasible_sln);
 
+    if (incumbent && constraints::satisfies_all(prob, best_feasible_sln)) {
+        incumbent->update(objective(prob, best_feasible_sln));
+    }
+
     if (constraints::satisfies_all(prob, best_sln) ||
         !constraints::satisfies_all(prob, best_feasible_sln)) {
         return std::min(best_sln, best_feasible_sln, less);
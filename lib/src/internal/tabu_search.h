@@ -1,10 +1,12 @@
 #pragma once
 
+#include "improvement_heuristics.h"
 #include "problem.h"
 #include "solution.h"
 
 namespace vrp {
 namespace detail {
-Solution tabu_search(const Problem& prob, const Solution& initial_sln);
+Solution tabu_search(const Problem& prob, const Solution& initial_sln,
+                     SharedIncumbent* incumbent = nullptr);
 }  // namespace detail
 }  // namespace vrp
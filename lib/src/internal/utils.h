@@ -1,27 +1,123 @@
 #pragma once
 
 #include <algorithm>
-#include <sstream>
+#include <cstdint>
 #include <string>
 #include <vector>
 
 namespace vrp {
 namespace detail {
-/// Splits string by delimiter
-static std::vector<std::string> split(const std::string& src, char delimiter) {
-    std::vector<std::string> dst;
-    std::istringstream ss_src(src);
-    std::string tmp;
-    while (std::getline(ss_src, tmp, delimiter)) {
-        dst.push_back(tmp);
-    }
-    for (auto& value : dst) {
-        auto space_pos = std::remove(value.begin(), value.end(), ' ');
-        if (space_pos != value.end()) {
-            value.erase(space_pos);
-        }
+/// Non-owning range of characters within input buffer
+struct TextRange {
+    const char* first = nullptr;
+    const char* last = nullptr;
+
+    inline bool empty() const noexcept { return first == last; }
+    inline size_t size() const noexcept { return last - first; }
+    inline std::string str() const { return std::string(first, last); }
+};
+
+/// Removes leading and trailing spaces
+inline TextRange trim(TextRange src) {
+    while (src.first != src.last && *src.first == ' ') {
+        ++src.first;
+    }
+    while (src.first != src.last && *(src.last - 1) == ' ') {
+        --src.last;
+    }
+    return src;
+}
+
+/// Copies range into string without spaces
+inline std::string without_spaces(TextRange src) {
+    std::string value = src.str();
+    value.erase(std::remove(value.begin(), value.end(), ' '), value.end());
+    return value;
+}
+
+/// Gets next field of the row starting at src.first. Trailing delimiter does
+/// not produce an empty field
+inline bool next_field(TextRange& src, char delimiter, TextRange& field) {
+    if (src.empty()) {
+        return false;
+    }
+    const char* end = std::find(src.first, src.last, delimiter);
+    field = {src.first, end};
+    src.first = (end == src.last) ? end : end + 1;
+    return true;
+}
+
+/// Splits range by delimiter
+inline std::vector<TextRange> split(TextRange src, char delimiter) {
+    std::vector<TextRange> dst;
+    TextRange field = {};
+    while (next_field(src, delimiter, field)) {
+        dst.push_back(field);
     }
     return dst;
 }
+
+/// Converts range to int. Plain decimal values are converted in place, other
+/// values fall back to std::stoi
+inline int to_int(TextRange src) {
+    src = trim(src);
+    const char* p = src.first;
+    const bool negative = (p != src.last && *p == '-');
+    if (p != src.last && (*p == '-' || *p == '+')) {
+        ++p;
+    }
+    const auto digits = src.last - p;
+    if (digits > 0 && digits <= 9 &&
+        std::all_of(p, src.last, [](char c) { return c >= '0' && c <= '9'; })) {
+        int value = 0;
+        for (; p != src.last; ++p) {
+            value = value * 10 + (*p - '0');
+        }
+        return negative ? -value : value;
+    }
+    return std::stoi(without_spaces(src));
+}
+
+/// Converts range to double. Decimal values with up to 15 significant digits
+/// are converted in place: both mantissa and power of 10 are exact doubles,
+/// so a single division gives the correctly rounded value, same as
+/// std::stod. Other values fall back to std::stod
+inline double to_double(TextRange src) {
+    static const double powers_of_10[] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    constexpr const int max_digits = 15;
+    constexpr const int max_scale = 22;
+
+    src = trim(src);
+    const char* p = src.first;
+    const bool negative = (p != src.last && *p == '-');
+    if (p != src.last && (*p == '-' || *p == '+')) {
+        ++p;
+    }
+    uint64_t mantissa = 0;
+    int significant = 0, scale = 0;
+    bool has_digits = false, has_dot = false, fast = true;
+    for (; p != src.last && fast; ++p) {
+        if (*p >= '0' && *p <= '9') {
+            has_digits = true;
+            if (mantissa != 0 || *p != '0') {
+                ++significant;
+            }
+            mantissa = mantissa * 10 + (*p - '0');
+            scale += has_dot;
+            fast = significant <= max_digits && scale <= max_scale;
+        } else if (*p == '.' && !has_dot) {
+            has_dot = true;
+        } else {
+            fast = false;
+        }
+    }
+    if (fast && has_digits) {
+        const double value = static_cast<double>(mantissa) / powers_of_10[scale];
+        return negative ? -value : value;
+    }
+    return std::stod(without_spaces(src));
+}
 }  // namespace detail
 }  // namespace vrp
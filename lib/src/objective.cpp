@@ -1,18 +1,76 @@
 #include "objective.h"
 
+#include <sstream>
+#include <stdexcept>
+
 namespace vrp {
+namespace {
+/// Add route's objective to the value, reading combined arc costs or
+/// interleaved arcs if available
+template<typename ListIt>
+inline void add_route_objective(const Problem& prob, Solution::VehicleIndex vi,
+                                ListIt first, ListIt last, double& value) {
+    const auto& vehicle = prob.vehicles[vi];
+    if (prob.combined_arc_costs()) {
+        const auto& arc_costs = prob.arc_costs(vi);
+        for (auto next = std::next(first); next != last; ++first, ++next) {
+            value += arc_costs(*first, *next);
+        }
+    } else if (!prob.arcs.empty()) {
+        for (auto next = std::next(first); next != last; ++first, ++next) {
+            const auto& arc = prob.arcs(*first, *next);
+            value += vehicle.variable_cost * arc.cost;
+            value += prob.time_coeff * arc.time;
+        }
+    } else {
+        for (auto next = std::next(first); next != last; ++first, ++next) {
+            value += vehicle.variable_cost * prob.costs(*first, *next);
+            value += prob.time_coeff * prob.times(*first, *next);
+        }
+    }
+    value += vehicle.fixed_cost;
+}
+
+/// Get cached route objective. If built with CHECK_OBJECTIVE_CACHE, the
+/// value is verified against full computation
+inline double cached_objective(const Problem& prob, Solution::VehicleIndex vi,
+                               const Solution::RouteType& route) {
+#if VRP_CHECK_OBJECTIVE_CACHE
+    const double expected = objective(prob, vi, route);
+    if (route.objective() != expected) {
+        std::stringstream ss;
+        ss << "cached route objective is out of date: (expected) " << expected
+           << " vs " << route.objective() << " (actual)";
+        throw std::logic_error(ss.str());
+    }
+#endif
+    return route.objective();
+}
+}  // namespace
 
 double objective(const Problem& prob, const Solution& sln) {
     double objective_value = 0.;
     for (const auto& vehicle_route : sln.routes) {
-        const auto& vehicle = prob.vehicles[vehicle_route.first];
         const auto& route = vehicle_route.second;
-        for (auto i = route.cbegin(), j = std::next(i); j != route.cend();
-             ++i, ++j) {
-            objective_value += vehicle.variable_cost * prob.costs[*i][*j];
-            objective_value += prob.time_coeff * prob.times[*i][*j];
+        // sum of route values: the same result whether cached or not
+        objective_value += route.has_objective(vehicle_route.first)
+                               ? cached_objective(prob, vehicle_route.first,
+                                                  route)
+                               : objective(prob, vehicle_route.first, route);
+    }
+    return objective_value;
+}
+
+double objective(const Problem& prob, Solution& sln) {
+    double objective_value = 0.;
+    for (auto& vehicle_route : sln.routes) {
+        auto& route = vehicle_route.second;
+        if (!route.has_objective(vehicle_route.first)) {
+            route.set_objective(
+                vehicle_route.first,
+                objective(prob, vehicle_route.first, route));
         }
-        objective_value += vehicle.fixed_cost;
+        objective_value += cached_objective(prob, vehicle_route.first, route);
     }
     return objective_value;
 }
@@ -20,13 +78,8 @@ double objective(const Problem& prob, const Solution& sln) {
 double objective(const Problem& prob, Solution::VehicleIndex vi,
                  const Solution::RouteType& route) {
     double objective_value = 0.;
-    const auto& vehicle = prob.vehicles[vi];
-    for (auto i = route.cbegin(), j = std::next(i); j != route.cend();
-         ++i, ++j) {
-        objective_value += vehicle.variable_cost * prob.costs[*i][*j];
-        objective_value += prob.time_coeff * prob.times[*i][*j];
-    }
-    objective_value += vehicle.fixed_cost;
+    add_route_objective(prob, vi, route.cbegin(), route.cend(),
+                        objective_value);
     return objective_value;
 }
 
@@ -36,7 +89,7 @@ double cost_function(const Problem& prob, const Solution& sln) {
         const auto& route = vehicle_route.second;
         for (auto i = route.cbegin(), j = std::next(i); j != route.cend();
              ++i, ++j) {
-            cost += prob.costs[*i][*j];
+            cost += prob.costs(*i, *j);
         }
     }
     return cost;
@@ -0,0 +1,105 @@
+#include "perf_counters.h"
+
+#include "src/internal/counters.h"
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace vrp {
+namespace perf {
+namespace {
+/// counters of all threads. blocks are never freed: pool threads may exit
+/// before the totals are written
+std::mutex g_registry_mutex;
+std::vector<std::unique_ptr<Counters>> g_registry;
+
+const char* operator_name(size_t op) {
+    static const char* names[OPERATORS_COUNT] = {
+        "relocate",
+        "exchange",
+        "two_opt",
+        "cross",
+        "relocate_new_route",
+        "relocate_split",
+        "route_save",
+        "intra_relocate",
+        "merge_splits"};
+    return names[op];
+}
+
+const char* outcome_name(size_t outcome) {
+    static const char* names[OUTCOMES_COUNT] = {
+        "evaluated",
+        "accepted",
+        "rejected_tabu",
+        "rejected_capacity",
+        "rejected_time_windows",
+        "not_improving"};
+    return names[outcome];
+}
+
+Counters total_counters() {
+    Counters total;
+    std::lock_guard<std::mutex> lock(g_registry_mutex);
+    for (const auto& counters : g_registry) {
+        for (size_t op = 0; op < OPERATORS_COUNT; ++op) {
+            for (size_t o = 0; o < OUTCOMES_COUNT; ++o) {
+                total.moves[op][o] += counters->moves[op][o];
+            }
+            total.calls[op] += counters->calls[op];
+            total.nanoseconds[op] += counters->nanoseconds[op];
+        }
+        total.tabu_iterations += counters->tabu_iterations;
+        total.tabu_nanoseconds += counters->tabu_nanoseconds;
+    }
+    return total;
+}
+
+inline double seconds(uint64_t nanoseconds) { return nanoseconds * 1e-9; }
+}  // namespace
+
+Counters& local_counters() {
+    thread_local Counters* counters = nullptr;
+    if (!counters) {
+        std::lock_guard<std::mutex> lock(g_registry_mutex);
+        g_registry.emplace_back(std::make_unique<Counters>());
+        counters = g_registry.back().get();
+    }
+    return *counters;
+}
+
+bool enabled() noexcept { return VRP_PERF_COUNTERS; }
+
+uint64_t tabu_iterations() { return total_counters().tabu_iterations; }
+
+void reset() {
+    std::lock_guard<std::mutex> lock(g_registry_mutex);
+    for (auto& counters : g_registry) {
+        *counters = Counters{};
+    }
+}
+
+void write_json(std::ostream& out) {
+    if (!enabled()) {
+        out << "{\"enabled\": false}" << std::endl;
+        return;
+    }
+    const auto total = total_counters();
+    out << "{\n  \"enabled\": true,\n";
+    out << "  \"tabu_iterations\": {\"count\": " << total.tabu_iterations
+        << ", \"seconds\": " << seconds(total.tabu_nanoseconds) << "},\n";
+    out << "  \"operators\": {";
+    for (size_t op = 0; op < OPERATORS_COUNT; ++op) {
+        out << (op ? ",\n" : "\n") << "    \"" << operator_name(op)
+            << "\": {\"calls\": " << total.calls[op]
+            << ", \"seconds\": " << seconds(total.nanoseconds[op]);
+        for (size_t o = 0; o < OUTCOMES_COUNT; ++o) {
+            out << ", \"" << outcome_name(o) << "\": " << total.moves[op][o];
+        }
+        out << "}";
+    }
+    out << "\n  }\n}" << std::endl;
+}
+}  // namespace perf
+}  // namespace vrp
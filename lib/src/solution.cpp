@@ -1,6 +1,9 @@
 #include "solution.h"
+#include "constraints.h"
 
+#include <algorithm>
 #include <cassert>
+#include <stdexcept>
 
 namespace vrp {
 void transfer_split_entry(bool enable_splits, SplitInfo& src, SplitInfo& dst,
@@ -16,20 +19,77 @@ void transfer_split_entry(bool enable_splits, SplitInfo& src, SplitInfo& dst,
         return;
     }
 
+    // customers served in full by any route need no entries
+    if (src.full && dst.full) {
+        return;
+    }
+
     // the key shouldn't exist in dst
     if (dst.has(key)) {
         throw std::runtime_error("given key exists in dst already");
     }
 
     auto& src_info = src.split_info;
-    auto& dst_info = dst.split_info;
-
     auto src_it = src_info.find(key);
-    if (src_info.cend() == src_it) {
+    if (src_info.end() == src_it) {
         throw std::out_of_range("given key is not in src");
     }
-    dst_info.emplace(src_it->first, src_it->second);
-    src_info.erase(src_it);
+    dst.split_info[key] = src_it->second;
+    src_info.erase(key);
+}
+
+void CustomerOwners::reset(size_t customers, size_t max_owners) {
+    m_capacity = std::max(size_t(1), max_owners);
+    m_slots.resize(customers * m_capacity);
+    m_sizes.assign(customers, 0);
+}
+
+size_t CustomerOwners::at(size_t customer, size_t route) const {
+    for (const auto& owner : (*this)[customer]) {
+        if (owner.first == route) {
+            return owner.second;
+        }
+    }
+    throw std::out_of_range("route does not serve given customer");
+}
+
+void CustomerOwners::set(size_t customer, size_t route, size_t index) {
+    assert(customer < size());
+    Owner* owners = first(customer);
+    const size_t size = m_sizes[customer];
+    size_t i = 0;
+    for (; i < size && owners[i].first > route; ++i) {
+    }
+    if (i < size && owners[i].first == route) {
+        owners[i].second = index;
+        return;
+    }
+    if (size == m_capacity) {
+        throw std::runtime_error("customer has more owners than max splits");
+    }
+    std::copy_backward(owners + i, owners + size, owners + size + 1);
+    owners[i] = {route, index};
+    ++m_sizes[customer];
+}
+
+void CustomerOwners::erase(size_t customer, size_t route) {
+    assert(customer < size());
+    Owner* owners = first(customer);
+    Owner* last = owners + m_sizes[customer];
+    Owner* it = std::find_if(owners, last, [route](const Owner& owner) {
+        return owner.first == route;
+    });
+    if (it == last) {
+        return;
+    }
+    std::copy(it + 1, last, it);
+    --m_sizes[customer];
+}
+
+void CustomerOwners::rename(size_t customer, size_t route, size_t new_route) {
+    const auto index = at(customer, route);
+    erase(customer, route);
+    set(customer, new_route, index);
 }
 
 void Solution::update_times(const Problem& prob) {
@@ -39,30 +99,25 @@ void Solution::update_times(const Problem& prob) {
 
     sln.times.reserve(sln.routes.size());
     for (const auto& values : sln.routes) {
-        sln.times.emplace_back(values.first, std::list<vrp::RoutePointTime>{});
+        sln.times.emplace_back(values.first,
+                               std::vector<vrp::RoutePointTime>{});
     }
-    // TODO: optimize
-    static const auto at = [](const auto& list, size_t i) {
-        if (list.size() <= i) {
-            throw std::out_of_range("index out of list's range");
-        }
-        return *std::next(list.begin(), i);
-    };
     const auto& customers = prob.customers;
     for (size_t ri = 0; ri < sln.routes.size(); ++ri) {
         const auto& route = sln.routes[ri].second;
         auto& time = sln.times[ri].second;
+        time.reserve(route.size());
         int start_time = 0;
         for (size_t i = 0; i < route.size() - 1; ++i) {
-            auto c = at(route, i);
-            auto next_c = at(route, i + 1);
+            auto c = route[i];
+            auto next_c = route[i + 1];
 
             RoutePointTime t;
             t.arrive = start_time;
             t.start = std::max(t.arrive, customers[c].hard_tw.first);
             t.finish = t.start + customers[c].service_time;
 
-            start_time = t.finish + prob.times[c][next_c];
+            start_time = t.finish + prob.times(c, next_c);
 
             time.emplace_back(std::move(t));
         }
@@ -72,9 +127,8 @@ void Solution::update_times(const Problem& prob) {
 }
 
 void Solution::update_customer_owners(const Problem& prob) {
-    customer_owners.resize(prob.n_customers());  // TODO: free on same size?
-    const auto empty_hash_map = std::unordered_map<size_t, size_t>{};
-    std::fill(customer_owners.begin(), customer_owners.end(), empty_hash_map);
+    customer_owners.reset(prob.n_customers(),
+                          static_cast<size_t>(prob.max_splits));
 
     const auto size = routes.size();
     for (size_t ri = 0; ri < size; ++ri) {
@@ -88,15 +142,13 @@ void Solution::update_customer_owners(const Problem& prob, size_t route_index,
     assert(customer_owners.size() == prob.n_customers());
 
     const auto& route = routes[route_index].second;
-    auto first = std::next(route.cbegin(), first_customer_index);
+    auto first = route.cbegin() + first_customer_index;
     for (size_t i = first_customer_index; first != route.cend(); ++first, ++i) {
         // skip depot
         if (*first == 0) {
             continue;
         }
-        customer_owners[*first][route_index] = i;
-        assert(customer_owners[*first].size() <=
-               static_cast<size_t>(prob.max_splits));
+        customer_owners.set(*first, route_index, i);
     }
 }
 
@@ -108,6 +160,136 @@ void Solution::update_used_vehicles() {
     }
 }
 
+void Solution::update_tw_segments(const Problem& prob) {
+    tw_segments.resize(routes.size());
+    for (size_t ri = 0, size = routes.size(); ri < size; ++ri) {
+        update_tw_segments(prob, ri);
+    }
+}
+
+void Solution::update_tw_segments(const Problem& prob, size_t route_index) {
+    if (tw_segments.size() < routes.size()) {
+        tw_segments.resize(routes.size());
+    }
+
+    const auto& route = routes[route_index].second;
+    const auto& info = route_splits[route_index];
+    auto& forward = tw_segments[route_index].forward;
+    auto& backward = tw_segments[route_index].backward;
+    const auto size = route.size();
+    forward.resize(size);
+    backward.resize(size);
+    if (size == 0) {
+        return;
+    }
+
+    forward[0] = constraints::tw_start_segment(prob, info, route[0]);
+    for (size_t i = 1; i < size; ++i) {
+        forward[i] = constraints::tw_concatenate(
+            prob, forward[i - 1], route[i - 1], route[i],
+            constraints::tw_segment(prob, info, route[i]));
+        // prefix start time is fixed, so violated time can be made exact
+        forward[i].violated_time =
+            forward[i - 1].violated_time +
+            std::max(0, forward[i].earliest -
+                            prob.customers[route[i]].hard_tw.second);
+    }
+
+    backward[size - 1] = constraints::tw_segment(prob, info, route[size - 1]);
+    for (size_t i = size - 1; i > 0; --i) {
+        backward[i - 1] = constraints::tw_concatenate(
+            prob, constraints::tw_segment(prob, info, route[i - 1]),
+            route[i - 1], route[i], backward[i]);
+    }
+
+    assert(forward.back().violated_time ==
+           constraints::total_violated_time(prob, info, route.cbegin(),
+                                            route.cend()));
+}
+
+void SolutionJournal::begin(const Solution& sln) {
+    m_entries.clear();
+    m_routes_count = sln.routes.size();
+    m_tw_count = sln.tw_segments.size();
+    m_active = true;
+}
+
+void SolutionJournal::record_route(const Solution& sln, size_t route_index) {
+    assert(m_active);
+    // appended routes are removed on rollback, nothing to record
+    if (route_index >= m_routes_count) {
+        return;
+    }
+    const auto recorded = std::find_if(
+        m_entries.cbegin(), m_entries.cend(),
+        [route_index](const RouteEntry& e) { return e.index == route_index; });
+    if (recorded != m_entries.cend()) {
+        return;
+    }
+
+    m_entries.emplace_back();
+    auto& entry = m_entries.back();
+    entry.index = route_index;
+    entry.vehicle = sln.routes[route_index].first;
+    entry.route = sln.routes[route_index].second;
+    entry.split = sln.route_splits[route_index];
+    if (route_index < m_tw_count) {
+        entry.tw = sln.tw_segments[route_index];
+    }
+}
+
+void SolutionJournal::commit() {
+    m_entries.clear();
+    m_active = false;
+}
+
+void SolutionJournal::rollback(Solution& sln) {
+    assert(m_active);
+    if (sln.routes.size() < m_routes_count) {
+        throw std::logic_error("routes were erased during transaction");
+    }
+
+    // owners are erased for all changed routes before any of them is set
+    // back: customer never has more owners than max splits
+    const auto erase_owners = [&sln](size_t ri) {
+        for (size_t customer : sln.routes[ri].second) {
+            if (customer != 0) {
+                sln.customer_owners.erase(customer, ri);
+            }
+        }
+    };
+    for (size_t ri = m_routes_count, size = sln.routes.size(); ri < size;
+         ++ri) {
+        erase_owners(ri);
+        sln.used_vehicles.erase(sln.routes[ri].first);
+    }
+    for (const auto& entry : m_entries) {
+        erase_owners(entry.index);
+    }
+
+    sln.routes.resize(m_routes_count);
+    sln.route_splits.resize(m_routes_count);
+    sln.tw_segments.resize(m_tw_count);
+    for (auto& entry : m_entries) {
+        const size_t ri = entry.index;
+        sln.routes[ri].first = entry.vehicle;
+        sln.routes[ri].second = std::move(entry.route);
+        sln.route_splits[ri] = std::move(entry.split);
+        if (ri < m_tw_count) {
+            sln.tw_segments[ri] = std::move(entry.tw);
+        }
+
+        const auto& route = sln.routes[ri].second;
+        for (size_t i = 0, size = route.size(); i < size; ++i) {
+            if (route[i] != 0) {
+                sln.customer_owners.set(route[i], ri, i);
+            }
+        }
+    }
+    m_entries.clear();
+    m_active = false;
+}
+
 bool Solution::operator==(const Solution& other) const {
     if (this->routes.size() != other.routes.size()) {
         return false;
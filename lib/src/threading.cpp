@@ -0,0 +1,219 @@
+#include "threading.h"
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <thread>
+#include <vector>
+
+namespace vrp {
+namespace threading {
+namespace {
+std::mutex g_pool_mutex;
+std::unique_ptr<ThreadPool> g_pool = nullptr;
+size_t g_workers_count = 0;
+
+size_t hardware_workers_count() {
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+}  // namespace
+
+struct ThreadPool::Impl {
+    /// task queue owned by a worker
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+
+    std::atomic<size_t> queued{0};      ///< number of tasks in all queues
+    std::atomic<size_t> next_queue{0};  ///< queue for external pushes
+    std::mutex mutex;                   ///< guards stop, used for sleeping
+    std::condition_variable wake_up;
+    bool stop = false;
+
+    /// pool and queue of the calling worker thread
+    static thread_local const Impl* current_pool;
+    static thread_local size_t current_queue;
+
+    explicit Impl(size_t count) {
+        queues.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            queues.emplace_back(std::make_unique<Queue>());
+        }
+        workers.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            workers.emplace_back([this, i]() { work(i); });
+        }
+    }
+
+    ~Impl() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        wake_up.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    /// queue of the calling worker, round robin choice for other threads
+    size_t home_queue() {
+        if (current_pool == this) {
+            return current_queue;
+        }
+        return next_queue.fetch_add(1) % queues.size();
+    }
+
+    void push(Task task) {
+        auto& queue = *queues[home_queue()];
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks.emplace_back(std::move(task));
+        }
+        ++queued;
+        // lock pairs with the check in sleep(): wake up is not lost
+        { std::lock_guard<std::mutex> lock(mutex); }
+        wake_up.notify_one();
+    }
+
+    /// take task from the back of own queue or steal from the front of other
+    /// queues
+    bool pop(size_t index, Task& task) {
+        if (queued.load() == 0) {
+            return false;
+        }
+        const size_t size = queues.size();
+        for (size_t k = 0; k < size; ++k) {
+            auto& queue = *queues[(index + k) % size];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.tasks.empty()) {
+                continue;
+            }
+            if (k == 0) {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+            } else {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+            }
+            --queued;
+            return true;
+        }
+        return false;
+    }
+
+    void work(size_t index) {
+        current_pool = this;
+        current_queue = index;
+        Task task;
+        while (true) {
+            if (pop(index, task)) {
+                task();
+                task = nullptr;
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(mutex);
+            wake_up.wait(lock, [this]() { return stop || queued.load() != 0; });
+            if (stop && queued.load() == 0) {
+                return;
+            }
+        }
+    }
+};
+
+thread_local const ThreadPool::Impl* ThreadPool::Impl::current_pool = nullptr;
+thread_local size_t ThreadPool::Impl::current_queue = 0;
+
+ThreadPool::ThreadPool(size_t workers)
+    : m_impl(std::make_unique<Impl>(std::max(size_t(1), workers))) {}
+
+ThreadPool::~ThreadPool() = default;
+
+size_t ThreadPool::size() const noexcept { return m_impl->workers.size(); }
+
+void ThreadPool::push(Task task) { m_impl->push(std::move(task)); }
+
+bool ThreadPool::run_pending_task() {
+    Task task;
+    if (!m_impl->pop(m_impl->home_queue(), task)) {
+        return false;
+    }
+    task();
+    return true;
+}
+
+ThreadPool& default_pool() {
+    std::lock_guard<std::mutex> lock(g_pool_mutex);
+    if (!g_pool) {
+        g_pool = std::make_unique<ThreadPool>(
+            g_workers_count ? g_workers_count : hardware_workers_count());
+    }
+    return *g_pool;
+}
+
+void set_workers_count(size_t count) {
+    std::lock_guard<std::mutex> lock(g_pool_mutex);
+    g_workers_count = count;
+    g_pool = nullptr;
+}
+
+size_t workers_count() {
+    std::lock_guard<std::mutex> lock(g_pool_mutex);
+    return g_workers_count ? g_workers_count : hardware_workers_count();
+}
+
+TaskGroup::TaskGroup(ThreadPool& pool) : m_pool(pool) {}
+
+TaskGroup::~TaskGroup() {
+    try {
+        wait();
+    } catch (...) {
+        // exception is only reported via explicit wait()
+    }
+}
+
+void TaskGroup::finish(std::exception_ptr error) {
+    // notify under lock: waiting thread may destroy the group right after
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (error && !m_error) {
+        m_error = error;
+    }
+    if (--m_pending == 0) {
+        m_done.notify_all();
+    }
+}
+
+void TaskGroup::wait() {
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_pending == 0) {
+                break;
+            }
+        }
+        // help executing tasks instead of blocking a thread
+        if (m_pool.run_pending_task()) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_done.wait_for(lock, std::chrono::milliseconds(1),
+                            [this]() { return m_pending == 0; })) {
+            break;
+        }
+    }
+
+    std::exception_ptr error = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::swap(error, m_error);
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+}  // namespace threading
+}  // namespace vrp
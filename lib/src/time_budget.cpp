@@ -0,0 +1,46 @@
+#include "time_budget.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace vrp {
+namespace time_budget {
+namespace {
+using clock = std::chrono::steady_clock;
+
+// lock-free atomics: safe to access from signal handlers
+std::atomic<bool> g_stop{false};
+std::atomic<int64_t> g_deadline{0};  ///< clock ticks, 0 means no limit
+}  // namespace
+
+void set_time_limit(double seconds) {
+    if (seconds <= 0.0) {
+        g_deadline.store(0);
+        return;
+    }
+    const auto limit = std::chrono::duration_cast<clock::duration>(
+        std::chrono::duration<double>(seconds));
+    g_deadline.store((clock::now() + limit).time_since_epoch().count());
+}
+
+void reset() noexcept {
+    g_deadline.store(0);
+    g_stop.store(false);
+}
+
+void request_stop() noexcept { g_stop.store(true); }
+
+bool expired() noexcept {
+    if (g_stop.load(std::memory_order_relaxed)) {
+        return true;
+    }
+    const auto deadline = g_deadline.load(std::memory_order_relaxed);
+    if (deadline != 0 && clock::now().time_since_epoch().count() >= deadline) {
+        g_stop.store(true, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+}  // namespace time_budget
+}  // namespace vrp
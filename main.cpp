@@ -1,14 +1,18 @@
+#include "binary_parser.h"
 #include "constraints.h"
 #include "csv_parser.h"
 #include "improvement_heuristics.h"
 #include "initial_heuristics.h"
 #include "logging.h"
 #include "objective.h"
+#include "perf_counters.h"
 #include "solution.h"
 #include "threading.h"
+#include "time_budget.h"
 #include "transportation_quantity.h"
 
 #include <algorithm>
+#include <csignal>
 #include <fstream>
 #include <iterator>
 #include <sstream>
@@ -108,6 +112,10 @@ void print_fmt(const vrp::Problem& prob, double objective, double cost_function,
 }
 
 void deduplicate(const vrp::Problem& prob, std::vector<vrp::Solution>& slns) {
+    // cache route objectives once, comparisons below only read them
+    for (auto& sln : slns) {
+        vrp::objective(prob, sln);
+    }
     std::sort(slns.begin(), slns.end(),
               [&prob](const auto& a, const auto& b) -> bool {
                   return objective(prob, a) < objective(prob, b);
@@ -118,13 +126,20 @@ void deduplicate(const vrp::Problem& prob, std::vector<vrp::Solution>& slns) {
 
 constexpr const size_t INITIAL_SLN_COUNT = 20;
 
+/// stop the solve gracefully: best solution found so far is written. repeated
+/// signal terminates the program
+void handle_stop_signal(int signal) {
+    vrp::time_budget::request_stop();
+    std::signal(signal, SIG_DFL);
+}
+
 }  // namespace
 
 /// Main entry-point to solver
 int main(int argc, char* argv[]) {
     if (argc < 2) {
         std::cerr << "Wrong number of input arguments" << std::endl;
-        std::cerr << "Usage: vrp_solver CSV_INPUT_FILE [DELIMITER]"
+        std::cerr << "Usage: vrp_solver CSV_OR_BINARY_INPUT_FILE [DELIMITER]"
                   << std::endl;
         return 1;
     }
@@ -133,6 +148,17 @@ int main(int argc, char* argv[]) {
         delimiter = argv[2][0];
     }
 
+    // wall-clock time limit of the whole solve in seconds. 0 means no limit
+    double time_limit = [](char* c) -> double {
+        if (!c) {
+            return 0.0;
+        }
+        return std::max(0.0, std::atof(c));
+    }(std::getenv("TIME_LIMIT"));
+    vrp::time_budget::set_time_limit(time_limit);
+    std::signal(SIGINT, handle_stop_signal);
+    std::signal(SIGTERM, handle_stop_signal);
+
     bool print_debug_info = [](char* c) {
         if (!c) {
             return false;
@@ -141,9 +167,54 @@ int main(int argc, char* argv[]) {
         return env_val == "YES" || env_val == "Y" || env_val == "1";
     }(std::getenv("PRINT_DEBUG_INFO"));
 
+    // granular neighbourhoods: number of nearest neighbours explored per
+    // customer by local search. 0 means explore all customers
+    size_t granular_neighbours = [](char* c) -> size_t {
+        if (!c) {
+            return 0;
+        }
+        return static_cast<size_t>(std::max(0, std::atoi(c)));
+    }(std::getenv("GRANULAR_NEIGHBOURS"));
+
+    // combined arc costs: local search and objective use one precomputed
+    // matrix per distinct vehicle variable cost, including the time term
+    bool combined_arc_costs = [](char* c) {
+        if (!c) {
+            return false;
+        }
+        auto env_val = std::string(c);
+        return env_val == "YES" || env_val == "Y" || env_val == "1";
+    }(std::getenv("COMBINED_ARC_COSTS"));
+
+    // file to write performance counters to at exit
+    std::string perf_counters_path = [](char* c) -> std::string {
+        if (!c) {
+            return "";
+        }
+        return c;
+    }(std::getenv("PERF_COUNTERS_FILE"));
+
+    // number of worker threads for parallel stages. 0 means number of
+    // hardware threads
+    size_t worker_threads = [](char* c) -> size_t {
+        if (!c) {
+            return 0;
+        }
+        return static_cast<size_t>(std::max(0, std::atoi(c)));
+    }(std::getenv("WORKER_THREADS"));
+    vrp::threading::set_workers_count(worker_threads);
+
     vrp::CsvParser parser(delimiter);
-    FileHandler input(argv[1]);
-    auto problem = parser.read(input.get());
+    // binary input is memory-mapped, CSV input is parsed
+    auto problem = [&parser](const std::string& path) {
+        if (vrp::BinaryParser::is_binary(path)) {
+            return vrp::BinaryParser().read(path);
+        }
+        FileHandler input(path);
+        return parser.read(input.get());
+    }(argv[1]);
+    problem.set_up_neighbours(granular_neighbours);
+    problem.set_up_arc_costs(combined_arc_costs);
 
     std::vector<vrp::InitialHeuristic> initial_heuristics = {
         vrp::InitialHeuristic::Savings, vrp::InitialHeuristic::Insertion,
@@ -156,13 +227,19 @@ int main(int argc, char* argv[]) {
                               vrp::InitialHeuristic::Savings};
     }
 
+    // heuristics are independent: run them in parallel, keep their order in
+    // the list of solutions
+    std::vector<std::vector<vrp::Solution>> heuristic_solutions(
+        initial_heuristics.size());
+    vrp::threading::parallel_for(initial_heuristics.size(), [&](size_t i) {
+        heuristic_solutions[i] = vrp::create_initial_solutions(
+            problem, initial_heuristics[i], INITIAL_SLN_COUNT);
+    });
+
     std::vector<vrp::Solution> solutions = {};
-    for (auto heuristic : initial_heuristics) {
-        auto heuristic_solutions = vrp::create_initial_solutions(
-            problem, heuristic, INITIAL_SLN_COUNT);
-        solutions.insert(solutions.end(),
-                         std::make_move_iterator(heuristic_solutions.begin()),
-                         std::make_move_iterator(heuristic_solutions.end()));
+    for (auto& slns : heuristic_solutions) {
+        solutions.insert(solutions.end(), std::make_move_iterator(slns.begin()),
+                         std::make_move_iterator(slns.end()));
     }
 
     if (solutions.empty()) {
@@ -181,13 +258,15 @@ int main(int argc, char* argv[]) {
         print_main_info(problem, best_initial_sln, "Initial");
     }
 
+    // run times differ a lot: schedule each run as a separate task. runs
+    // share best feasible objective to stop early when far behind
     std::vector<vrp::Solution> improved_solutions(solutions.size());
-    vrp::threading::parallel_range(improved_solutions.size(), [&](size_t first,
-                                                                  size_t last) {
-        for (; first != last; ++first) {
-            improved_solutions[first] = std::move(create_improved_solution(
-                problem, solutions[first], vrp::ImprovementHeuristic::Tabu));
-        }
+    vrp::SharedIncumbent incumbent;
+    vrp::threading::parallel_tasks(improved_solutions.size(), [&](size_t i) {
+        improved_solutions[i] =
+            create_improved_solution(problem, solutions[i],
+                                     vrp::ImprovementHeuristic::Tabu,
+                                     &incumbent);
     });
 
     // delete equal improved solutions
@@ -235,5 +314,10 @@ int main(int argc, char* argv[]) {
         }
     }
 
+    if (!perf_counters_path.empty()) {
+        std::ofstream perf_counters_file(perf_counters_path);
+        vrp::perf::write_json(perf_counters_file);
+    }
+
     return 0;
 }
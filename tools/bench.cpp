@@ -0,0 +1,402 @@
+#include "binary_parser.h"
+#include "constraints.h"
+#include "csv_parser.h"
+#include "improvement_heuristics.h"
+#include "initial_heuristics.h"
+#include "objective.h"
+#include "perf_counters.h"
+#include "solution.h"
+#include "threading.h"
+#include "time_budget.h"
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+constexpr const size_t INITIAL_SLN_COUNT = 20;
+
+/// Best-known Solomon solutions: total distance of the solutions with the
+/// minimal number of vehicles
+const std::unordered_map<std::string, double>& solomon_bks() {
+    static const std::unordered_map<std::string, double> bks = {
+        {"c101", 828.94},   {"c102", 828.94},   {"c103", 828.06},
+        {"c104", 824.78},   {"c105", 828.94},   {"c106", 828.94},
+        {"c107", 828.94},   {"c108", 828.94},   {"c109", 828.94},
+        {"c201", 591.56},   {"c202", 591.56},   {"c203", 591.17},
+        {"c204", 590.60},   {"c205", 588.88},   {"c206", 588.49},
+        {"c207", 588.29},   {"c208", 588.32},   {"r101", 1650.80},
+        {"r102", 1486.12},  {"r103", 1292.68},  {"r104", 1007.31},
+        {"r105", 1377.11},  {"r106", 1252.03},  {"r107", 1104.66},
+        {"r108", 960.88},   {"r109", 1194.73},  {"r110", 1118.84},
+        {"r111", 1096.72},  {"r112", 982.14},   {"r201", 1252.37},
+        {"r202", 1191.70},  {"r203", 939.50},   {"r204", 825.52},
+        {"r205", 994.42},   {"r206", 906.14},   {"r207", 890.61},
+        {"r208", 726.82},   {"r209", 909.16},   {"r210", 939.37},
+        {"r211", 885.71},   {"rc101", 1696.95}, {"rc102", 1554.75},
+        {"rc103", 1261.67}, {"rc104", 1135.48}, {"rc105", 1629.44},
+        {"rc106", 1424.73}, {"rc107", 1230.48}, {"rc108", 1139.82},
+        {"rc201", 1406.94}, {"rc202", 1365.65}, {"rc203", 1049.62},
+        {"rc204", 798.46},  {"rc205", 1297.65}, {"rc206", 1146.32},
+        {"rc207", 1061.14}, {"rc208", 828.14}};
+    return bks;
+}
+
+/// Benchmark settings
+struct Options {
+    std::vector<std::string> instances;     ///< instance files
+    std::vector<size_t> threads = {0};      ///< worker counts, 0 means all
+    size_t repetitions = 1;                 ///< runs per instance and threads
+    std::string format = "csv";             ///< csv or json
+    char delimiter = ';';                   ///< CSV input delimiter
+    size_t neighbours = 0;                  ///< granular neighbourhoods size
+    bool combined_arc_costs = false;        ///< use combined arc costs
+    double time_limit = 0.0;                ///< time limit of a run
+};
+
+/// Measurements of a single run
+struct Result {
+    std::string instance;
+    size_t threads = 0;
+    size_t repetition = 0;
+    double parse_seconds = 0.0;
+    double initial_seconds = 0.0;
+    double improvement_seconds = 0.0;
+    double total_seconds = 0.0;
+    uint64_t tabu_iterations = 0;
+    double objective = 0.0;
+    bool feasible = false;
+    size_t routes = 0;
+    double bks = 0.0;  ///< 0 if unknown
+};
+
+using clock = std::chrono::steady_clock;
+
+double seconds_since(clock::time_point start) {
+    return std::chrono::duration<double>(clock::now() - start).count();
+}
+
+std::string file_name(const std::string& path) {
+    const auto slash = path.find_last_of("/\\");
+    auto name = slash == std::string::npos ? path : path.substr(slash + 1);
+    const auto dot = name.find_last_of('.');
+    return dot == std::string::npos ? name : name.substr(0, dot);
+}
+
+bool is_directory(const std::string& path) {
+    struct stat info;
+    return stat(path.c_str(), &info) == 0 && S_ISDIR(info.st_mode);
+}
+
+/// Get instance files: directories are expanded into their sorted .csv and
+/// .bin files
+std::vector<std::string> expand(const std::vector<std::string>& paths) {
+    std::vector<std::string> files;
+    for (const auto& path : paths) {
+        if (!is_directory(path)) {
+            files.emplace_back(path);
+            continue;
+        }
+        DIR* dir = opendir(path.c_str());
+        if (!dir) {
+            throw std::runtime_error("cannot open directory: '" + path + "'");
+        }
+        std::vector<std::string> dir_files;
+        while (const dirent* entry = readdir(dir)) {
+            const std::string name = entry->d_name;
+            const auto dot = name.find_last_of('.');
+            const auto ext =
+                dot == std::string::npos ? std::string() : name.substr(dot);
+            if (ext == ".csv" || ext == ".bin") {
+                dir_files.emplace_back(path + "/" + name);
+            }
+        }
+        closedir(dir);
+        std::sort(dir_files.begin(), dir_files.end());
+        files.insert(files.end(), dir_files.begin(), dir_files.end());
+    }
+    return files;
+}
+
+vrp::Problem read_problem(const std::string& path, char delimiter) {
+    if (vrp::BinaryParser::is_binary(path)) {
+        return vrp::BinaryParser().read(path);
+    }
+    std::ifstream in(path);
+    if (!in.good()) {
+        throw std::runtime_error("something is wrong with the file path "
+                                 "provided: '" +
+                                 path + "'");
+    }
+    return vrp::CsvParser(delimiter).read(in);
+}
+
+void deduplicate(const vrp::Problem& prob, std::vector<vrp::Solution>& slns) {
+    for (auto& sln : slns) {
+        vrp::objective(prob, sln);
+    }
+    std::sort(slns.begin(), slns.end(),
+              [&prob](const auto& a, const auto& b) -> bool {
+                  return objective(prob, a) < objective(prob, b);
+              });
+    slns.erase(std::unique(slns.begin(), slns.end()), slns.end());
+}
+
+/// Solve instance the same way vrp_solver does, measuring each stage
+Result run(const Options& options, const std::string& path) {
+    Result result;
+    result.instance = file_name(path);
+    const auto& bks = solomon_bks();
+    const auto found = bks.find(result.instance);
+    result.bks = found == bks.cend() ? 0.0 : found->second;
+
+    vrp::perf::reset();
+    vrp::time_budget::reset();
+    vrp::time_budget::set_time_limit(options.time_limit);
+    const auto start = clock::now();
+
+    auto stage_start = clock::now();
+    auto problem = read_problem(path, options.delimiter);
+    problem.set_up_neighbours(options.neighbours);
+    problem.set_up_arc_costs(options.combined_arc_costs);
+    result.parse_seconds = seconds_since(stage_start);
+
+    stage_start = clock::now();
+    std::vector<vrp::InitialHeuristic> initial_heuristics = {
+        vrp::InitialHeuristic::Savings, vrp::InitialHeuristic::Insertion,
+        vrp::InitialHeuristic::ParallelInsertion,
+        vrp::InitialHeuristic::ClusterFirstRouteSecond};
+    if (problem.enable_splits()) {
+        initial_heuristics = {vrp::InitialHeuristic::ClusterFirstRouteSecond,
+                              vrp::InitialHeuristic::Savings};
+    }
+    std::vector<std::vector<vrp::Solution>> heuristic_solutions(
+        initial_heuristics.size());
+    vrp::threading::parallel_for(initial_heuristics.size(), [&](size_t i) {
+        heuristic_solutions[i] = vrp::create_initial_solutions(
+            problem, initial_heuristics[i], INITIAL_SLN_COUNT);
+    });
+    std::vector<vrp::Solution> solutions;
+    for (auto& slns : heuristic_solutions) {
+        solutions.insert(solutions.end(), std::make_move_iterator(slns.begin()),
+                         std::make_move_iterator(slns.end()));
+    }
+    if (solutions.empty()) {
+        throw std::runtime_error("no initial solutions were created");
+    }
+    deduplicate(problem, solutions);
+    result.initial_seconds = seconds_since(stage_start);
+
+    stage_start = clock::now();
+    std::vector<vrp::Solution> improved_solutions(solutions.size());
+    vrp::SharedIncumbent incumbent;
+    vrp::threading::parallel_tasks(improved_solutions.size(), [&](size_t i) {
+        improved_solutions[i] =
+            create_improved_solution(problem, solutions[i],
+                                     vrp::ImprovementHeuristic::Tabu,
+                                     &incumbent);
+    });
+    deduplicate(problem, improved_solutions);
+    result.improvement_seconds = seconds_since(stage_start);
+
+    // best feasible solution, best of all if none is feasible
+    const auto less = [&problem](const auto& a, const auto& b) {
+        const bool feasible_a = vrp::constraints::satisfies_all(problem, a),
+                   feasible_b = vrp::constraints::satisfies_all(problem, b);
+        if (feasible_a != feasible_b) {
+            return feasible_a;
+        }
+        return objective(problem, a) < objective(problem, b);
+    };
+    const auto& best = *std::min_element(improved_solutions.cbegin(),
+                                         improved_solutions.cend(), less);
+    result.total_seconds = seconds_since(start);
+    result.tabu_iterations = vrp::perf::tabu_iterations();
+    result.objective = objective(problem, best);
+    result.feasible = vrp::constraints::satisfies_all(problem, best);
+    result.routes = best.routes.size();
+    return result;
+}
+
+double iterations_per_second(const Result& r) {
+    return r.improvement_seconds > 0.0
+               ? r.tabu_iterations / r.improvement_seconds
+               : 0.0;
+}
+
+/// gap to best-known solution in percents
+double gap(const Result& r) {
+    return r.bks > 0.0 ? 100.0 * (r.objective - r.bks) / r.bks : 0.0;
+}
+
+void write_csv(std::ostream& out, const std::vector<Result>& results) {
+    out << "instance,threads,repetition,parse_s,initial_s,improvement_s,"
+           "total_s,tabu_iterations,iterations_per_s,objective,feasible,"
+           "routes,bks,gap_percent\n";
+    for (const auto& r : results) {
+        out << r.instance << "," << r.threads << "," << r.repetition << ","
+            << r.parse_seconds << "," << r.initial_seconds << ","
+            << r.improvement_seconds << "," << r.total_seconds << ",";
+        if (vrp::perf::enabled()) {
+            out << r.tabu_iterations << "," << iterations_per_second(r);
+        } else {
+            out << ",";
+        }
+        out << "," << r.objective << "," << r.feasible << "," << r.routes
+            << ",";
+        if (r.bks > 0.0) {
+            out << r.bks << "," << gap(r);
+        } else {
+            out << ",";
+        }
+        out << "\n";
+    }
+    out << std::flush;
+}
+
+void write_json(std::ostream& out, const std::vector<Result>& results) {
+    out << "[";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        out << (i ? ",\n" : "\n") << "  {\"instance\": \"" << r.instance
+            << "\", \"threads\": " << r.threads
+            << ", \"repetition\": " << r.repetition
+            << ", \"parse_s\": " << r.parse_seconds
+            << ", \"initial_s\": " << r.initial_seconds
+            << ", \"improvement_s\": " << r.improvement_seconds
+            << ", \"total_s\": " << r.total_seconds;
+        if (vrp::perf::enabled()) {
+            out << ", \"tabu_iterations\": " << r.tabu_iterations
+                << ", \"iterations_per_s\": " << iterations_per_second(r);
+        }
+        out << ", \"objective\": " << r.objective
+            << ", \"feasible\": " << (r.feasible ? "true" : "false")
+            << ", \"routes\": " << r.routes;
+        if (r.bks > 0.0) {
+            out << ", \"bks\": " << r.bks << ", \"gap_percent\": " << gap(r);
+        }
+        out << "}";
+    }
+    out << "\n]" << std::endl;
+}
+
+std::vector<size_t> parse_list(const std::string& value) {
+    std::vector<size_t> list;
+    std::stringstream ss(value);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        list.emplace_back(std::stoul(item));
+    }
+    if (list.empty()) {
+        throw std::invalid_argument("empty list: '" + value + "'");
+    }
+    return list;
+}
+
+void print_usage() {
+    std::cerr
+        << "Usage: vrp_bench [OPTIONS] INSTANCE_FILE_OR_DIR...\n"
+           "Options:\n"
+           "  -r N        repetitions per instance and thread count "
+           "(default 1)\n"
+           "  -t N[,N...] worker thread counts, 0 means all hardware "
+           "threads (default 0)\n"
+           "  -f FORMAT   output format: csv or json (default csv)\n"
+           "  -d CHAR     CSV input delimiter (default ';')\n"
+           "  -n K        granular neighbourhoods size (default 0: off)\n"
+           "  -c          use combined arc costs\n"
+           "  -l SECONDS  time limit of a run (default 0: no limit)\n"
+           "Example: vrp_bench -r 3 -t 1,4 test_data/solomon\n"
+           "Tabu iterations are reported if built with WITH_PERF_COUNTERS"
+        << std::endl;
+}
+
+Options parse_options(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const auto value = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("missing value of " + arg);
+            }
+            return argv[++i];
+        };
+        if (arg == "-r") {
+            options.repetitions = std::max(1ul, std::stoul(value()));
+        } else if (arg == "-t") {
+            options.threads = parse_list(value());
+        } else if (arg == "-f") {
+            options.format = value();
+            if (options.format != "csv" && options.format != "json") {
+                throw std::invalid_argument("unknown format: '" +
+                                            options.format + "'");
+            }
+        } else if (arg == "-d") {
+            options.delimiter = value()[0];
+        } else if (arg == "-n") {
+            options.neighbours = std::stoul(value());
+        } else if (arg == "-c") {
+            options.combined_arc_costs = true;
+        } else if (arg == "-l") {
+            options.time_limit = std::stod(value());
+        } else if (!arg.empty() && arg[0] == '-') {
+            throw std::invalid_argument("unknown option: '" + arg + "'");
+        } else {
+            options.instances.emplace_back(arg);
+        }
+    }
+    options.instances = expand(options.instances);
+    if (options.instances.empty()) {
+        throw std::invalid_argument("no instances provided");
+    }
+    return options;
+}
+}  // namespace
+
+/// Benchmark of the solver over instance sets: stage times, tabu iterations
+/// per second, objective and gap to best-known Solomon solutions
+int main(int argc, char* argv[]) {
+    Options options;
+    try {
+        options = parse_options(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        print_usage();
+        return 1;
+    }
+
+    std::vector<Result> results;
+    for (const auto threads : options.threads) {
+        vrp::threading::set_workers_count(threads);
+        for (const auto& instance : options.instances) {
+            for (size_t rep = 0; rep < options.repetitions; ++rep) {
+                auto result = run(options, instance);
+                result.threads = vrp::threading::workers_count();
+                result.repetition = rep;
+                std::cerr << result.instance << " [threads "
+                          << result.threads << ", run " << rep
+                          << "]: " << result.objective << " in "
+                          << result.total_seconds << " s" << std::endl;
+                results.emplace_back(std::move(result));
+            }
+        }
+    }
+
+    if (options.format == "json") {
+        write_json(std::cout, results);
+    } else {
+        write_csv(std::cout, results);
+    }
+    return 0;
+}
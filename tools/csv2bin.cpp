@@ -0,0 +1,39 @@
+#include "binary_parser.h"
+#include "csv_parser.h"
+
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+/// Converter of CSV problem files into binary format
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Wrong number of input arguments" << std::endl;
+        std::cerr << "Usage: vrp_csv2bin CSV_INPUT_FILE BINARY_OUTPUT_FILE "
+                     "[DELIMITER]"
+                  << std::endl;
+        return 1;
+    }
+    char delimiter = ';';
+    if (argc > 3) {
+        delimiter = argv[3][0];
+    }
+
+    std::ifstream in(argv[1]);
+    if (!in.good()) {
+        std::cerr << "something is wrong with the file path provided: "
+                  << "'" << argv[1] << "'" << std::endl;
+        return 1;
+    }
+    auto problem = vrp::CsvParser(delimiter).read(in);
+
+    std::ofstream out(argv[2], std::ios::binary | std::ios::trunc);
+    if (!out.good()) {
+        std::cerr << "cannot open output file: '" << argv[2] << "'"
+                  << std::endl;
+        return 1;
+    }
+    vrp::BinaryParser().write(out, problem);
+    return 0;
+}
@@ -0,0 +1,429 @@
+#include "binary_parser.h"
+#include "problem.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+/// Generator settings
+struct Options {
+    std::string output;           ///< output file, "-" is standard output
+    bool binary = false;          ///< write binary format instead of CSV
+    char delimiter = ';';         ///< CSV output delimiter
+    uint64_t seed = 1;            ///< random seed
+    size_t customers = 1000;      ///< number of customers, depot excluded
+    size_t clusters = 0;          ///< number of clusters, 0 is uniform
+    double clustered = 1.0;       ///< share of customers placed in clusters
+    double tightness = 0.5;       ///< time windows tightness in [0, 1]
+    size_t vehicle_types = 1;     ///< number of vehicle types
+    double site_dependent = 0.0;  ///< share of customers with restricted
+                                  /// suitable vehicles
+    int max_splits = 1;           ///< max number of vehicles per customer
+    int max_demand = 40;          ///< max demand of a customer
+};
+
+constexpr const int SERVICE_TIME = 10;
+constexpr const int BASE_CAPACITY = 200;
+constexpr const double BASE_FIXED_COST = 100.0;
+constexpr const double FLEET_SLACK = 1.5;
+
+/// Random numbers computed from mt19937_64 output only: standard
+/// distributions are implementation-defined, instances must not depend on
+/// the standard library
+class Random {
+    std::mt19937_64 m_engine;
+
+public:
+    explicit Random(uint64_t seed) : m_engine(seed) {}
+
+    /// Uniform in [0, 1)
+    double uniform() {
+        return static_cast<double>(m_engine() >> 11) / 9007199254740992.0;
+    }
+
+    /// Uniform in [first, last)
+    double uniform(double first, double last) {
+        return first + (last - first) * uniform();
+    }
+
+    /// Uniform integer in [first, last]
+    int uniform_int(int first, int last) {
+        const auto range = static_cast<uint64_t>(last - first) + 1;
+        return first + static_cast<int>(m_engine() % range);
+    }
+
+    /// Standard normal (Box-Muller)
+    double normal() {
+        const double u = 1.0 - uniform();
+        return std::sqrt(-2.0 * std::log(u)) *
+               std::cos(2.0 * 3.14159265358979323846 * uniform());
+    }
+};
+
+struct Point {
+    double x = 0.0;
+    double y = 0.0;
+};
+
+/// Generated instance: coordinates instead of matrices, so that CSV output
+/// streams matrix rows without storing them
+struct Instance {
+    std::vector<Point> points;  ///< depot is the first point
+    std::vector<vrp::Customer> customers;
+    std::vector<vrp::Vehicle> vehicles;
+    int max_splits = 1;
+
+    /// Euclidean distance rounded to 2 decimals
+    double cost(size_t i, size_t j) const {
+        const double d =
+            std::hypot(points[i].x - points[j].x, points[i].y - points[j].y);
+        return std::round(d * 100.0) / 100.0;
+    }
+
+    /// Travel time: truncated distance as in Solomon instances
+    int time(size_t i, size_t j) const {
+        return static_cast<int>(cost(i, j));
+    }
+};
+
+std::vector<Point> generate_points(const Options& options, double side,
+                                   Random& random) {
+    std::vector<Point> points;
+    points.reserve(options.customers + 1);
+    points.push_back({side / 2, side / 2});
+
+    std::vector<Point> centers;
+    for (size_t i = 0; i < options.clusters; ++i) {
+        centers.push_back({random.uniform(0, side), random.uniform(0, side)});
+    }
+    // clusters cover a fixed share of the area regardless of their count
+    const double spread =
+        side / (8.0 * std::sqrt(static_cast<double>(centers.size() + 1)));
+    const auto clamp = [side](double v) {
+        return std::min(side, std::max(0.0, v));
+    };
+    for (size_t i = 0; i < options.customers; ++i) {
+        if (!centers.empty() && random.uniform() < options.clustered) {
+            const auto& center =
+                centers[random.uniform_int(0, int(centers.size()) - 1)];
+            points.push_back({clamp(center.x + spread * random.normal()),
+                              clamp(center.y + spread * random.normal())});
+        } else {
+            points.push_back(
+                {random.uniform(0, side), random.uniform(0, side)});
+        }
+    }
+    return points;
+}
+
+/// Vehicle types are multiples of the base capacity: larger vehicles have
+/// lower fixed cost per unit of capacity, but higher variable cost
+std::vector<vrp::Vehicle> generate_vehicles(const Options& options,
+                                            vrp::TransportationQuantity total) {
+    std::vector<vrp::Vehicle> vehicles;
+    const auto types = options.vehicle_types;
+    for (size_t t = 0; t < types; ++t) {
+        const int capacity = BASE_CAPACITY * static_cast<int>(t + 1);
+        const double demand_share =
+            static_cast<double>(std::max(total.volume, total.weight)) / types;
+        const auto count = static_cast<size_t>(
+            std::ceil(FLEET_SLACK * demand_share / capacity) + 1);
+        for (size_t i = 0; i < count; ++i) {
+            vrp::Vehicle v;
+            v.id = static_cast<int>(vehicles.size());
+            v.capacity = {capacity, capacity};
+            v.fixed_cost =
+                std::round(BASE_FIXED_COST * std::pow(double(t + 1), 0.8));
+            v.variable_cost = 1.0 + 0.25 * static_cast<double>(t);
+            vehicles.emplace_back(v);
+        }
+    }
+    return vehicles;
+}
+
+/// Restrict customer to a random subset of vehicle types that can deliver its
+/// demand within max splits
+std::vector<int> generate_suitable(const Options& options,
+                                   const std::vector<vrp::Vehicle>& vehicles,
+                                   vrp::TransportationQuantity demand,
+                                   Random& random) {
+    const auto fits = [&options, &demand](const vrp::Vehicle& v) {
+        return demand.volume <= v.capacity.volume * options.max_splits &&
+               demand.weight <= v.capacity.weight * options.max_splits;
+    };
+    const auto types = options.vehicle_types;
+    std::vector<bool> chosen(types, false);
+    bool any = false;
+    for (size_t t = 0; t < types; ++t) {
+        chosen[t] = random.uniform() < 0.5;
+        any |= chosen[t];
+    }
+    if (!any) {
+        chosen[random.uniform_int(0, int(types) - 1)] = true;
+    }
+    // the largest type fits by construction
+    std::vector<int> suitable;
+    for (bool retry : {false, true}) {
+        for (const auto& v : vehicles) {
+            const size_t t =
+                static_cast<size_t>(v.capacity.volume / BASE_CAPACITY) - 1;
+            if ((chosen[t] || (retry && t + 1 == types)) && fits(v)) {
+                suitable.push_back(v.id);
+            }
+        }
+        if (!suitable.empty()) {
+            break;
+        }
+    }
+    return suitable;
+}
+
+Instance generate(const Options& options) {
+    Random random(options.seed);
+    Instance instance;
+    instance.max_splits = options.max_splits;
+
+    // Solomon density: 100 customers on a 100x100 square
+    const double side =
+        10.0 * std::sqrt(static_cast<double>(options.customers));
+    instance.points = generate_points(options, side, random);
+
+    // horizon allows to reach any customer and serve a route of 20 customers
+    const int horizon =
+        static_cast<int>(std::ceil(3.0 * side)) + 20 * SERVICE_TIME;
+
+    vrp::Customer depot;
+    depot.hard_tw = depot.soft_tw = {0, horizon};
+    instance.customers.push_back(depot);
+
+    vrp::TransportationQuantity total;
+    for (size_t c = 1; c <= options.customers; ++c) {
+        vrp::Customer customer;
+        customer.id = static_cast<int>(c);
+        // equal volume and weight as in Solomon and real-life instances
+        const int demand = random.uniform_int(1, options.max_demand);
+        customer.demand = {demand, demand};
+        customer.service_time = SERVICE_TIME;
+
+        // window within the times the customer is reachable and the vehicle
+        // is back at depot on time. tightness 0 gives the widest windows,
+        // tightness 1 gives windows of service time
+        const int earliest = instance.time(0, c);
+        const int latest = std::max(
+            earliest, horizon - instance.time(c, 0) - 2 * SERVICE_TIME);
+        const int width = std::max(
+            SERVICE_TIME,
+            static_cast<int>((1.0 - options.tightness) * (latest - earliest)));
+        const int begin =
+            random.uniform_int(earliest, std::max(earliest, latest - width));
+        customer.hard_tw = customer.soft_tw = {begin, begin + width};
+
+        total.volume += customer.demand.volume;
+        total.weight += customer.demand.weight;
+        instance.customers.emplace_back(std::move(customer));
+    }
+
+    instance.vehicles = generate_vehicles(options, total);
+
+    for (size_t c = 1; c <= options.customers; ++c) {
+        if (random.uniform() < options.site_dependent) {
+            auto& customer = instance.customers[c];
+            customer.suitable_vehicles = generate_suitable(
+                options, instance.vehicles, customer.demand, random);
+        }
+    }
+    return instance;
+}
+
+void write_csv(std::ostream& out, const Instance& instance, char delimiter) {
+    const auto d = delimiter;
+    const auto n = instance.points.size();
+    out << std::setprecision(10);
+
+    out << "table customer\n"
+        << "id" << d << "volume" << d << "weight" << d << "hard_tw_begin" << d
+        << "hard_tw_end" << d << "soft_tw_begin" << d << "soft_tw_end" << d
+        << "service_time" << d << "suitable_vehicles\n";
+    for (const auto& c : instance.customers) {
+        out << c.id << d << c.demand.volume << d << c.demand.weight << d
+            << c.hard_tw.first << d << c.hard_tw.second << d
+            << c.soft_tw.first << d << c.soft_tw.second << d << c.service_time;
+        for (int v : c.suitable_vehicles) {
+            out << d << v;
+        }
+        out << "\n";
+    }
+
+    out << "\ntable vehicle\n"
+        << "id" << d << "volume" << d << "weight" << d << "fixed_cost" << d
+        << "variable_cost\n";
+    for (const auto& v : instance.vehicles) {
+        out << v.id << d << v.capacity.volume << d << v.capacity.weight << d
+            << v.fixed_cost << d << v.variable_cost << "\n";
+    }
+
+    out << "\ntable cost\n";
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            out << instance.cost(i, j) << (j + 1 < n ? d : '\n');
+        }
+    }
+
+    out << "\ntable time\n";
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            out << instance.time(i, j) << (j + 1 < n ? d : '\n');
+        }
+    }
+
+    out << "\nvalue max_violated_soft_tw\n0\n"
+        << "\nvalue max_splits\n"
+        << instance.max_splits << "\n";
+    out << std::flush;
+}
+
+void write_binary(std::ostream& out, Instance instance) {
+    const auto n = instance.points.size();
+    vrp::Problem problem;
+    problem.customers = std::move(instance.customers);
+    problem.vehicles = std::move(instance.vehicles);
+    problem.costs = vrp::CostMatrix(n, n);
+    problem.times = vrp::TimeMatrix(n, n);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            problem.costs(i, j) =
+                static_cast<vrp::CostType>(instance.cost(i, j));
+            problem.times(i, j) = instance.time(i, j);
+        }
+    }
+    problem.max_violated_soft_tw = 0;
+    problem.max_splits = instance.max_splits;
+    vrp::BinaryParser().write(out, problem);
+}
+
+void print_usage() {
+    std::cerr
+        << "Usage: vrp_generate [OPTIONS] OUTPUT_FILE\n"
+           "Options:\n"
+           "  -s SEED     random seed (default 1)\n"
+           "  -n N        number of customers (default 1000)\n"
+           "  -c K        number of customer clusters (default 0: uniform)\n"
+           "  -p F        share of customers in clusters (default 1)\n"
+           "  -w F        time windows tightness from 0 (wide) to 1 "
+           "(default 0.5)\n"
+           "  -v T        number of vehicle types (default 1)\n"
+           "  -e F        share of site-dependent customers (default 0)\n"
+           "  -m S        max splits per customer (default 1)\n"
+           "  -q D        max customer demand (default 40)\n"
+           "  -b          write binary format instead of CSV\n"
+           "  -d CHAR     CSV output delimiter (default ';')\n"
+           "OUTPUT_FILE '-' writes CSV to standard output"
+        << std::endl;
+}
+
+double share(const std::string& arg, const std::string& value) {
+    const double v = std::stod(value);
+    if (v < 0.0 || v > 1.0) {
+        throw std::invalid_argument("value of " + arg + " must be in [0, 1]");
+    }
+    return v;
+}
+
+Options parse_options(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const auto value = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("missing value of " + arg);
+            }
+            return argv[++i];
+        };
+        if (arg == "-s") {
+            options.seed = std::stoull(value());
+        } else if (arg == "-n") {
+            options.customers = std::stoul(value());
+        } else if (arg == "-c") {
+            options.clusters = std::stoul(value());
+        } else if (arg == "-p") {
+            options.clustered = share(arg, value());
+        } else if (arg == "-w") {
+            options.tightness = share(arg, value());
+        } else if (arg == "-v") {
+            options.vehicle_types = std::max(1ul, std::stoul(value()));
+        } else if (arg == "-e") {
+            options.site_dependent = share(arg, value());
+        } else if (arg == "-m") {
+            options.max_splits = std::max(1, std::stoi(value()));
+        } else if (arg == "-q") {
+            options.max_demand = std::max(1, std::stoi(value()));
+        } else if (arg == "-b") {
+            options.binary = true;
+        } else if (arg == "-d") {
+            options.delimiter = value()[0];
+        } else if (arg.size() > 1 && arg[0] == '-') {
+            throw std::invalid_argument("unknown option: '" + arg + "'");
+        } else {
+            options.output = arg;
+        }
+    }
+    if (options.output.empty()) {
+        throw std::invalid_argument("no output file provided");
+    }
+    if (options.customers < 2) {
+        throw std::invalid_argument("at least 2 customers are required");
+    }
+    const int largest = BASE_CAPACITY * static_cast<int>(options.vehicle_types);
+    if (options.max_demand > largest * options.max_splits) {
+        throw std::invalid_argument(
+            "max demand exceeds capacity of the largest vehicle type times "
+            "max splits");
+    }
+    if (options.binary && options.output == "-") {
+        throw std::invalid_argument("binary output requires a file");
+    }
+    return options;
+}
+}  // namespace
+
+/// Generator of synthetic problem instances of any size. The same options and
+/// seed always produce the same instance
+int main(int argc, char* argv[]) {
+    Options options;
+    try {
+        options = parse_options(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        print_usage();
+        return 1;
+    }
+
+    auto instance = generate(options);
+
+    if (options.output == "-") {
+        write_csv(std::cout, instance, options.delimiter);
+        return 0;
+    }
+    std::ofstream out(options.output, options.binary
+                                          ? std::ios::binary | std::ios::trunc
+                                          : std::ios::trunc);
+    if (!out.good()) {
+        std::cerr << "cannot open output file: '" << options.output << "'"
+                  << std::endl;
+        return 1;
+    }
+    if (options.binary) {
+        write_binary(out, std::move(instance));
+    } else {
+        write_csv(out, instance, options.delimiter);
+    }
+    return 0;
+}
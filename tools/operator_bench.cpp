@@ -0,0 +1,266 @@
+#include "binary_parser.h"
+#include "csv_parser.h"
+#include "initial_heuristics.h"
+#include "perf_counters.h"
+#include "solution.h"
+
+#include "src/internal/counters.h"
+#include "src/internal/tabu/local_search.h"
+#include "src/internal/tabu/tabu_lists.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace {
+/// number of heap allocations made by the program
+std::atomic<uint64_t> g_allocations{0};
+
+void* allocate(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+}  // namespace
+
+// count allocations of the whole program, operators included
+void* operator new(std::size_t size) { return allocate(size); }
+void* operator new[](std::size_t size) { return allocate(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+/// Benchmark settings
+struct Options {
+    std::string instance;     ///< instance file
+    size_t warmup = 3;        ///< untimed calls per operator
+    size_t repetitions = 21;  ///< timed calls per operator
+    char delimiter = ';';     ///< CSV input delimiter
+    size_t neighbours = 0;    ///< granular neighbourhoods size
+    double tw_penalty = 1.2;  ///< time windows penalty of local search
+};
+
+/// Operator under benchmark
+struct OperatorCall {
+    std::string name;
+    vrp::perf::Operator id;
+    std::function<void(vrp::Solution&, vrp::tabu::TabuLists&)> call;
+};
+
+/// Measurements of an operator
+struct Result {
+    std::string name;
+    double median_us = 0.0;
+    double min_us = 0.0;
+    double allocations = 0.0;  ///< heap allocations per call
+    double evaluated = 0.0;    ///< moves evaluated per call
+};
+
+using clock = std::chrono::steady_clock;
+
+vrp::Problem read_problem(const std::string& path, char delimiter) {
+    if (vrp::BinaryParser::is_binary(path)) {
+        return vrp::BinaryParser().read(path);
+    }
+    std::ifstream in(path);
+    if (!in.good()) {
+        throw std::runtime_error("something is wrong with the file path "
+                                 "provided: '" +
+                                 path + "'");
+    }
+    return vrp::CsvParser(delimiter).read(in);
+}
+
+uint64_t evaluated_moves(vrp::perf::Operator op) {
+    return vrp::perf::local_counters()
+        .moves[static_cast<size_t>(op)]
+              [static_cast<size_t>(vrp::perf::Outcome::Evaluated)];
+}
+
+/// Call operator on copies of the same solution: every call does the same
+/// work. Only the operator call is measured
+Result run(const Options& options, const OperatorCall& op,
+           const vrp::Solution& initial_sln) {
+    Result result;
+    result.name = op.name;
+
+    const auto call = [&op, &initial_sln]() {
+        auto sln = initial_sln;
+        vrp::tabu::TabuLists lists{};
+        const auto allocations = g_allocations.load();
+        const auto evaluated = evaluated_moves(op.id);
+        const auto start = clock::now();
+        op.call(sln, lists);
+        const auto time = clock::now() - start;
+        return std::make_tuple(
+            std::chrono::duration<double, std::micro>(time).count(),
+            g_allocations.load() - allocations,
+            evaluated_moves(op.id) - evaluated);
+    };
+
+    for (size_t i = 0; i < options.warmup; ++i) {
+        call();
+    }
+
+    std::vector<double> times;
+    times.reserve(options.repetitions);
+    uint64_t allocations = 0, evaluated = 0;
+    for (size_t i = 0; i < options.repetitions; ++i) {
+        const auto measured = call();
+        times.emplace_back(std::get<0>(measured));
+        allocations += std::get<1>(measured);
+        evaluated += std::get<2>(measured);
+    }
+    std::sort(times.begin(), times.end());
+    result.median_us = times[times.size() / 2];
+    result.min_us = times.front();
+    result.allocations = double(allocations) / options.repetitions;
+    result.evaluated = double(evaluated) / options.repetitions;
+    return result;
+}
+
+void write_csv(std::ostream& out, const std::vector<Result>& results) {
+    out << "operator,median_us,min_us,allocations_per_call,"
+           "evaluated_per_call,moves_per_s\n";
+    for (const auto& r : results) {
+        out << r.name << "," << r.median_us << "," << r.min_us << ","
+            << r.allocations << ",";
+        if (vrp::perf::enabled()) {
+            out << r.evaluated << ","
+                << (r.median_us > 0.0 ? r.evaluated * 1e6 / r.median_us
+                                      : 0.0);
+        } else {
+            out << ",";
+        }
+        out << "\n";
+    }
+    out << std::flush;
+}
+
+void print_usage() {
+    std::cerr
+        << "Usage: vrp_operator_bench [OPTIONS] INSTANCE_FILE\n"
+           "Options:\n"
+           "  -w N        warmup calls per operator (default 3)\n"
+           "  -r N        timed calls per operator, median is reported "
+           "(default 21)\n"
+           "  -d CHAR     CSV input delimiter (default ';')\n"
+           "  -n K        granular neighbourhoods size (default 0: off)\n"
+           "Moves per second are reported if built with WITH_PERF_COUNTERS"
+        << std::endl;
+}
+
+Options parse_options(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const auto value = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("missing value of " + arg);
+            }
+            return argv[++i];
+        };
+        if (arg == "-w") {
+            options.warmup = std::stoul(value());
+        } else if (arg == "-r") {
+            options.repetitions = std::max(1ul, std::stoul(value()));
+        } else if (arg == "-d") {
+            options.delimiter = value()[0];
+        } else if (arg == "-n") {
+            options.neighbours = std::stoul(value());
+        } else if (!arg.empty() && arg[0] == '-') {
+            throw std::invalid_argument("unknown option: '" + arg + "'");
+        } else {
+            options.instance = arg;
+        }
+    }
+    if (options.instance.empty()) {
+        throw std::invalid_argument("no instance provided");
+    }
+    return options;
+}
+}  // namespace
+
+/// Microbenchmark of local search operators: each operator is applied to the
+/// same initial solution, reporting median time, heap allocations and moves
+/// evaluated per call
+int main(int argc, char* argv[]) {
+    Options options;
+    try {
+        options = parse_options(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        print_usage();
+        return 1;
+    }
+
+    auto problem = read_problem(options.instance, options.delimiter);
+    problem.set_up_neighbours(options.neighbours);
+
+    // fixed initial solution: first savings solution is deterministic
+    auto solutions = vrp::create_initial_solutions(
+        problem, vrp::InitialHeuristic::Savings, 1);
+    if (solutions.empty()) {
+        std::cerr << "no initial solution was created" << std::endl;
+        return 1;
+    }
+    auto initial_sln = std::move(solutions.front());
+    initial_sln.update_customer_owners(problem);
+    initial_sln.update_used_vehicles();
+
+    vrp::tabu::LocalSearchMethods ls(problem);
+    ls.violate_tw(true);
+    ls.penalize_tw(options.tw_penalty);
+
+    // route saving threshold as in tabu search: 5% of customers + 2
+    const auto threshold =
+        std::max(size_t(1), static_cast<size_t>(problem.n_customers() * 0.05)) +
+        2;
+
+    using vrp::perf::Operator;
+    const auto method = [&ls](size_t i) {
+        return [&ls, i](vrp::Solution& sln, vrp::tabu::TabuLists& lists) {
+            ls[i](sln, lists);
+        };
+    };
+    const std::vector<OperatorCall> operators = {
+        {"relocate", Operator::Relocate, method(0)},
+        {"exchange", Operator::Exchange, method(1)},
+        {"two_opt", Operator::TwoOpt, method(2)},
+        {"cross", Operator::Cross, method(3)},
+        {"relocate_new_route", Operator::RelocateNewRoute, method(4)},
+        {"relocate_split", Operator::RelocateSplit, method(5)},
+        {"route_save", Operator::RouteSave,
+         [&ls, threshold](vrp::Solution& sln, vrp::tabu::TabuLists&) {
+             ls.route_save(sln, threshold);
+         }},
+        {"intra_relocate", Operator::IntraRelocate,
+         [&ls](vrp::Solution& sln, vrp::tabu::TabuLists&) {
+             ls.intra_relocate(sln);
+         }},
+        {"merge_splits", Operator::MergeSplits,
+         [&ls](vrp::Solution& sln, vrp::tabu::TabuLists&) {
+             ls.merge_splits(sln);
+         }}};
+
+    std::vector<Result> results;
+    for (const auto& op : operators) {
+        results.emplace_back(run(options, op, initial_sln));
+    }
+    write_csv(std::cout, results);
+    return 0;
+}